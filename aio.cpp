@@ -2,78 +2,120 @@
 
 #define THREADS_PER_CORE 2
 #define MIN_THREADS      4
+#define HELP_SPINS       0x40 // Finding nothing to run, a helper spins this many times,
+#define HELP_YIELDS      0x10 // then gives up its time slice this many times before it parks.
 
 namespace exy {
 namespace aio {
 namespace __internal__ {
-BYTE* WorkProvider::pop() {
-    BYTE *work = nullptr;
-    AcquireSRWLockExclusive(&srw);
-    if (list.isNotEmpty()) {
-        work = list.pop();
-    }
-    ReleaseSRWLockExclusive(&srw);
-    return work;
-}
+/*  Chase-Lev deque of {Task}s: its owner pushes and pops at the bottom while other threads steal
+*   from the top. The capacity is fixed so that spawning never allocates; {push} fails when full.
+*/
+struct Deque {
+    static constexpr LONG64 capacity = 0x1000;
 
-struct Thread {
-    OVERLAPPED    overlapped;
-    Worker       *worker;
-    WorkerFn      workerFn;
-    WorkProvider &workProvider;
+    volatile LONG64 top;
+    volatile LONG64 bottom;
+    Task *volatile  tasks[capacity];
 
-    Thread(Worker *worker, WorkerFn workerFn, WorkProvider &workProvider)
-        : worker(worker), workerFn(workerFn), workProvider(workProvider) {}
+    bool push(Task *task) {
+        auto b = bottom;
+        if (b - top >= capacity) {
+            return false;
+        }
+        tasks[b & (capacity - 1)] = task;
+        bottom = b + 1; // Volatile store: {task} is visible before {bottom}.
+        return true;
+    }
 
-    void run(volatile long *counter) {
-        while (true) {
-            auto work = workProvider.pop();
-            if (work == nullptr) {
-                break;
+    Task* pop() {
+        auto b = bottom - 1;
+        InterlockedExchange64(&bottom, b); // Full fence: thieves must see {b} before {top} is read.
+        auto t = top;
+        if (t > b) {
+            bottom = b + 1;
+            return nullptr;
+        }
+        auto task = tasks[b & (capacity - 1)];
+        if (t == b) { // The last task: race thieves for it.
+            if (InterlockedCompareExchange64(&top, t + 1, t) != t) {
+                task = nullptr;
             }
-            (worker->*workerFn)(work);
+            bottom = b + 1;
         }
-        MemFree(this);
-        InterlockedDecrement(counter);
-        WakeByAddressSingle((void*)counter);
+        return task;
+    }
+
+    Task* steal() {
+        auto t = top;
+        MemoryBarrier();
+        auto b = bottom;
+        if (t >= b) {
+            return nullptr;
+        }
+        auto task = tasks[t & (capacity - 1)];
+        if (InterlockedCompareExchange64(&top, t + 1, t) != t) {
+            return nullptr;
+        }
+        return task;
     }
 };
 } // namespace aio::__internal__
 } // namespace aio
+
+using Deque = aio::__internal__::Deque;
+using  Task = aio::Task;
+
+namespace os = aio::os;
+
+static thread_local Deque *deque = nullptr; // This thread's deque, if it is the opener or a pool thread.
+static thread_local INT    victim = 0;      // Where this thread starts looking for tasks to steal.
+
 static auto numberOfThreads() {
-    SYSTEM_INFO si{};
-    GetSystemInfo(&si);
-    auto n = INT(si.dwNumberOfProcessors);
+    if (auto n = compiler.config.threads) {
+        return n;
+    }
+    auto n = INT(os::processors());
     auto m = n * THREADS_PER_CORE;
     return max(m, MIN_THREADS);
 }
 
+#define POISON_PILL uintptr_t(0) // Completion key that tells a pool thread to exit.
+
 struct Iocp {
-    HANDLE        handle{};
-    List<HANDLE>  threads{};
+    os::Queue     queue{};
+    List<os::Thread> threads{};
+    Deque        *deques{};  // [0] for the thread that opened the pool, then one per pool thread.
+    INT           numberOfDeques{};
+    volatile LONG nextDeque{};
     volatile LONG activeThreads{};
+    volatile LONG helpingThreads{};
     volatile LONG isRunning{};
+    volatile LONG work{};          // Bumped when a task is queued or done, for parked helpers to wait on.
+    volatile LONG parkedThreads{}; // Helpers waiting on {work}.
 
     auto open() {
         auto errors = 0;
         auto      n = numberOfThreads();
-        traceln("Starting %i#<green> threads (%i#<green> per core)", n, THREADS_PER_CORE);
-        handle = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, n);
-        if (handle == nullptr) {
-            OsError("CreateIoCompletionPort", nullptr);
+        logln(Aio, Info, "Starting %i#<green> threads", n);
+        queue = os::openQueue(n);
+        if (queue == nullptr) {
             return false;
         }
+        numberOfDeques = n + 1;
+        deques = MemAlloc<Deque>(numberOfDeques);
+        deque = &deques[0];
+        nextDeque = 1;
         isRunning = TRUE;
         for (auto i = 0; i < n; ++i) {
-            auto thread = CreateThread(nullptr, 0, loop, this, 0, nullptr);
+            auto thread = os::startThread(loop, this);
             if (thread == nullptr) {
-                OsError("CreateThread", nullptr);
                 ++errors;
             } else {
                 threads.append(thread);
             }
         }
-        waitUntilActiveThreadCountIs(n);
+        waitUntilActiveThreadCountIs(threads.length);
         return errors == 0;
     }
 
@@ -81,73 +123,127 @@ struct Iocp {
         if (isRunning == FALSE) {
             return;
         }
-        traceln("Stopping %i#<green> threads", threads.length);
+        logln(Aio, Info, "Stopping %i#<green> threads", threads.length);
         isRunning = FALSE;
-        if (WaitForMultipleObjects(threads.length, threads.items, 1, INFINITE) != WAIT_OBJECT_0) {
-            OsError("WaitForMultipleObjects", "Expected return value to be '%c#<green>'", "WAIT_OBJECT_0");
+        for (auto i = 0; i < threads.length; i++) {
+            os::post(queue, POISON_PILL);
         }
+        os::joinThreads(threads.items, threads.length);
         Assert(activeThreads == 0);
-        threads.dispose([](HANDLE thread) { 
-            if (CloseHandle(thread) == FALSE) {
-                OsError("CloseHandle", nullptr);
+        threads.dispose([](os::Thread thread) { os::closeThread(thread); });
+        if (queue != nullptr) {
+            os::closeQueue(queue);
+            queue = nullptr;
+        }
+        deque = nullptr;
+        deques = MemFree(deques);
+        numberOfDeques = 0;
+    }
+
+    void waitUntilActiveThreadCountIs(INT n) {
+        auto value = activeThreads;
+        while (value != n) {
+            os::wait(&activeThreads, value);
+            value = activeThreads;
+        }
+    }
+
+    // Pops from this thread's deque first, then tries to steal from every other deque once.
+    Task* next() {
+        if (deque != nullptr) {
+            if (auto task = deque->pop()) {
+                return task;
             }
-        });
-        if (handle != nullptr) {
-            if (CloseHandle(handle) == FALSE) {
-                OsError("CloseHandle", nullptr);
+        }
+        for (auto i = 0; i < numberOfDeques; i++) {
+            auto other = &deques[(victim + i) % numberOfDeques];
+            if (other != deque) {
+                if (auto task = other->steal()) {
+                    victim = (victim + i) % numberOfDeques;
+                    return task;
+                }
             }
-            handle = nullptr;
         }
+        return nullptr;
     }
 
-    void waitUntilActiveThreadCountIs(INT n) {
-        auto counter = &activeThreads;
-        while (*counter != n) {
-            if (WaitOnAddress(counter, (void*)counter, sizeof(*counter), 16) == 0) {
-                if (GetLastError() != ERROR_TIMEOUT) {
-                    OsError("WaitOnAddress", nullptr);
-                    break;
+    static void execute(Task *task);
+
+    // Wakes the parked helpers, if any. Bumping {work} first pairs with {help} counting itself as parked
+    // before it waits: either this sees the helper parked, or the helper sees {work} change.
+    void notify() {
+        InterlockedIncrement(&work);
+        if (parkedThreads != 0) {
+            os::wakeAll(&work);
+        }
+    }
+
+    // Runs whatever can be found until {task} is done. Finding nothing, spins, then yields, then parks
+    // until a task is queued or done, so that idle helpers do not hold on to cores in serial stretches.
+    void help(Task *task) {
+        auto idle = 0;
+        while (task->isPending) {
+            auto seen = work;
+            if (auto found = next()) {
+                execute(found);
+                idle = 0;
+            } else if (++idle < HELP_SPINS) {
+                os::pause();
+            } else if (idle < HELP_SPINS + HELP_YIELDS) {
+                os::yield();
+            } else {
+                InterlockedIncrement(&parkedThreads);
+                if (task->isPending) {
+                    os::wait(&work, seen);
                 }
+                InterlockedDecrement(&parkedThreads);
             }
         }
     }
 
-    static DWORD loop(void *param) {
+    static void loop(void *param) {
         auto iocp = (Iocp*)param;
+        deque  = &iocp->deques[InterlockedIncrement(&iocp->nextDeque) - 1];
+        victim = INT(deque - iocp->deques);
         InterlockedIncrement(&iocp->activeThreads);
-        WakeByAddressSingle((void*)&iocp->activeThreads);
-
-        traceln("   thread(%i#<green>#0x) started", GetCurrentThreadId());
-
-        while (iocp->isRunning == TRUE) {
-            DWORD bytesTransferred{};
-            ULONG_PTR completionKey{};
-            OVERLAPPED *overlapped{};
-            auto status = GetQueuedCompletionStatus(iocp->handle, &bytesTransferred,
-                                                    &completionKey, &overlapped, 1);
-            if (status == FALSE) {
-                auto hResult = GetLastError();
-                if (hResult == WAIT_TIMEOUT) {
-                    continue;
-                }
-                OsError("GetQueuedCompletionStatus", nullptr);
+        os::wakeOne(&iocp->activeThreads);
+
+        logln(Aio, Debug, "   thread(%i#<green>#0x) started", os::threadId());
+
+        // Blocks until there is work; {close} posts one poison pill per thread.
+        while (true) {
+            uintptr_t completionKey{};
+            if (!os::take(iocp->queue, completionKey)) {
+                break;
+            } else if (completionKey == POISON_PILL) {
+                break;
             } else {
-                auto thread = (aio::__internal__::Thread*)overlapped;
-                thread->run((volatile long*)completionKey);
+                stats::BusyTimer timer{};
+                stats::Event event{ "Aio", "help" };
+                iocp->help((Task*)completionKey);
+                InterlockedDecrement(&iocp->helpingThreads);
+                os::wakeOne(&iocp->helpingThreads);
             }
         }
 
         InterlockedDecrement(&iocp->activeThreads);
-        WakeByAddressSingle((void*)&iocp->activeThreads);
+        os::wakeOne(&iocp->activeThreads);
 
-        traceln("   thread(%i#<green>#0x) exited", GetCurrentThreadId());
-
-        return 0;
+        logln(Aio, Debug, "   thread(%i#<green>#0x) exited", os::threadId());
+        disposeFormats();
     }
 };
 
 static Iocp iocp{};
 
+void Iocp::execute(Task *task) {
+    stats::Event event{ "Aio", "task" };
+    stats::count(stats::Counter::AioTasks);
+    task->fn(task);
+    InterlockedExchange(&task->isPending, FALSE);
+    iocp.notify(); // A helper may be parked until this task is done.
+}
+
 namespace aio {
 bool open() {
     return iocp.open();
@@ -157,23 +253,113 @@ void close() {
     iocp.close();
 }
 
-namespace __internal__ {
-void post(Worker *worker, WorkProvider &workProvider, WorkerFn workerFn) {
-    const auto runners = iocp.threads.length;
-    static thread_local auto counter = 0;
-    static const auto           zero = 0;
-    counter = runners;
-    for (auto i = 0; i < runners; i++) {
-        auto thread = MemAlloc<Thread>();
-        thread = new(thread) Thread(worker, workerFn, workProvider);
-        PostQueuedCompletionStatus(iocp.handle, 0, (ULONG_PTR)&counter, (OVERLAPPED*)thread);
-    }
-    auto value = counter;
-    while (value != 0) {
-        WaitOnAddress(&counter, (void*)&zero, sizeof(counter), INFINITE);
-        value = counter;
+INT threads() {
+    return iocp.threads.length;
+}
+
+bool read(List<Read> &reads) {
+    return os::read(reads.items, reads.length);
+}
+
+void spawn(Task *task) {
+    task->isPending = TRUE;
+    if (deque == nullptr || !deque->push(task)) {
+        Iocp::execute(task);
+    } else {
+        iocp.notify();
     }
 }
+
+void join(Task *task) {
+    iocp.help(task);
+}
+
+void run(Task *task) {
+    if (deque != &iocp.deques[0] || iocp.threads.isEmpty()) {
+        // A pool thread (or no pool): whatever {task} spawns is stolen by threads already helping.
+        task->isPending = TRUE;
+        Iocp::execute(task);
+        return;
+    }
+    // The pool threads help until {task} is done. They hold on to {task} until then, so wait for
+    // all of them to let go before returning.
+    const auto helpers = iocp.threads.length;
+    task->isPending = TRUE;
+    iocp.helpingThreads = helpers;
+    for (auto i = 0; i < helpers; i++) {
+        os::post(iocp.queue, uintptr_t(task));
+    }
+    Iocp::execute(task);
+    auto value = iocp.helpingThreads;
+    while (value != 0) {
+        os::wait(&iocp.helpingThreads, value);
+        value = iocp.helpingThreads;
+    }
 }
 } // namespace aio
+
+//----------------------------------------------------------
+struct Status::Binder {
+    const Status *volatile waitingOn;
+};
+
+static thread_local Status::Binder binder{};
+
+/*  Follows the chain from {status} to its owner, to the status that owner waits on and so on. If the chain
+*   comes back to this thread, returns the binder in it that breaks the cycle: the one at the lowest
+*   address, so that every binder walking the same cycle picks the same one.
+*/
+static Status::Binder* findCycleBreaker(const Status *status) {
+    Status::Binder *breaker = nullptr;
+    for (auto hops = 0; status != nullptr && hops < 0x100; hops++) {
+        auto next = status->owner;
+        if (next == nullptr) {
+            return nullptr; // Not yet published by the binder that began {status}.
+        }
+        if (breaker == nullptr || next < breaker) {
+            breaker = next;
+        }
+        if (next == &binder) {
+            return breaker;
+        }
+        status = next->waitingOn;
+    }
+    return nullptr;
+}
+
+bool Status::begin() {
+    if (InterlockedCompareExchange(&value, Busy, Idle) == Idle) {
+        owner = &binder;
+        return true;
+    }
+    wait();
+    return false;
+}
+
+void Status::finish() {
+    Assert(value == Busy);
+    InterlockedExchange(&value, Done);
+    os::wakeAll(&value);
+}
+
+void Status::wait() {
+    // Publish what this thread waits on before walking the chain of owners so that of the threads
+    // closing a cycle at the same time, at least one of them sees it. A cycle would never end, so one
+    // thread in it returns and treats the wait like a recursive bind on a single thread. The others keep
+    // waiting, and are left alone until the breaker is done: if the thread that finds the cycle is not
+    // the breaker, it wakes the breaker to look again. Otherwise only {finish} wakes a waiter.
+    InterlockedExchangePointer((void* volatile*)&binder.waitingOn, (void*)this);
+    while (value == Busy) {
+        if (auto breaker = findCycleBreaker(this)) {
+            if (breaker == &binder) {
+                break;
+            }
+            if (auto status = breaker->waitingOn) {
+                os::wakeAll(&status->value);
+            }
+        }
+        os::wait(&value, Busy);
+    }
+    InterlockedExchangePointer((void* volatile*)&binder.waitingOn, nullptr);
+}
 } // namespace exy
\ No newline at end of file
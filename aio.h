@@ -1,31 +1,64 @@
 #pragma once
 
+#include "aio_os.h"
+
 namespace exy {
 namespace aio {
 bool open();
 void close();
+INT threads(); // Of the pool, besides the thread that opened it.
+
+/*  A unit of work for the thread pool. A {Task} is owned by whoever spawns it, usually on the
+*   stack of the spawning function, which must {join} it before it goes out of scope.
+*/
+struct Task {
+    void (*fn)(Task*);
+    volatile LONG isPending;
+};
+
+using Read = os::Read; // Of a file opened with {os::openForRead}.
+
+bool read(List<Read> &reads); // Starts all {reads} at once, then waits for every one of them to complete.
+
+void spawn(Task*); // Lets other threads steal {task}, or runs it now if this thread cannot queue it.
+void join(Task*);  // Runs queued or stolen tasks until {task} is done.
+void run(Task*);   // Runs {task} on this thread with every pool thread helping with what it spawns.
 
 namespace __internal__ {
-struct Worker { static auto next(void*) { Assert(0); return false; } };
-using WorkerFn = void(Worker::*)(void*);
+template<typename TWorker, typename WorkItem>
+struct ForEach : Task {
+    TWorker   &worker;
+    WorkItem **items;
+    INT        length;
 
-struct WorkProvider {
-    List<BYTE*> &list;
-    SRWLOCK      srw{};
+    ForEach(TWorker &worker, WorkItem **items, INT length)
+        : Task{ &ForEach::fork, FALSE }, worker(worker), items(items), length(length) {}
 
-    WorkProvider(List<BYTE*> &list) : list(list) {}
-    BYTE* pop();
-};
+    static void fork(Task *task) {
+        auto self = (ForEach*)task;
+        split(self->worker, self->items, self->length);
+    }
 
-void post(Worker *worker, WorkProvider &workProvider, WorkerFn workerFn);
+    // Spawns the right half and recurses into the left half, so that thieves take the biggest pieces.
+    static void split(TWorker &worker, WorkItem **items, INT length) {
+        if (length > 1) {
+            auto half = length / 2;
+            ForEach rhs{ worker, items + half, length - half };
+            spawn(&rhs);
+            split(worker, items, half);
+            join(&rhs);
+        } else if (length == 1) {
+            worker.run(items[0]);
+        }
+    }
+};
 } // namespace aio::__internal__
 
+// Calls {worker.run} once for each item of {workList}. {workList} is left as is.
 template<typename TWorker, typename WorkItem>
 void run(TWorker &worker, List<WorkItem*> &workList) {
-    __internal__::WorkProvider provider{ (List<BYTE*>&)workList };
-    __internal__::post((__internal__::Worker*)&worker, 
-                       provider, 
-                       (__internal__::WorkerFn)&TWorker::run);
+    __internal__::ForEach<TWorker, WorkItem> root{ worker, workList.items, workList.length };
+    run(&root);
 }
 } // namespace aio
 } // namespace exy
\ No newline at end of file
@@ -0,0 +1,389 @@
+#if defined(__linux__)
+#include "aio_os.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <linux/io_uring.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#define RING_ENTRIES 0x40
+
+/*  The Linux backend of {aio::os}. The pool threads block on a condition variable instead of a completion
+*   port, waits on an address are futexes, and a batch of reads is submitted to an io_uring at once. The
+*   rest of the compiler is still Win32, so this file builds on its own: g++ -std=c++17 -c aio_linux.cpp.
+*/
+namespace exy {
+namespace aio {
+namespace os {
+static thread_local uint32_t error{};
+
+int processors() {
+    auto n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? int(n) : 1;
+}
+
+void pause() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+void yield() {
+    sched_yield();
+}
+
+uint32_t threadId() {
+    return uint32_t(syscall(SYS_gettid));
+}
+
+//----------------------------------------------------------
+struct Start {
+    ThreadFn fn;
+    void    *param;
+};
+
+static void* start(void *param) {
+    auto s = *(Start*)param;
+    free(param);
+    s.fn(s.param);
+    return nullptr;
+}
+
+Thread startThread(ThreadFn fn, void *param) {
+    auto s = (Start*)malloc(sizeof(Start));
+    auto t = (pthread_t*)malloc(sizeof(pthread_t));
+    if (s == nullptr || t == nullptr) {
+        free(s);
+        free(t);
+        return nullptr;
+    }
+    *s = { fn, param };
+    if (pthread_create(t, nullptr, start, s) != 0) {
+        free(s);
+        free(t);
+        return nullptr;
+    }
+    return t;
+}
+
+bool joinThreads(Thread *threads, int count) {
+    auto ok = true;
+    for (auto i = 0; i < count; i++) {
+        ok &= pthread_join(*(pthread_t*)threads[i], nullptr) == 0;
+    }
+    return ok;
+}
+
+void closeThread(Thread thread) {
+    free(thread);
+}
+
+//----------------------------------------------------------
+struct Keys {
+    pthread_mutex_t mutex;
+    pthread_cond_t  posted;
+    uintptr_t      *items;
+    int             head, length, capacity;
+};
+
+Queue openQueue(int) {
+    auto q = (Keys*)calloc(1, sizeof(Keys));
+    if (q == nullptr) {
+        return nullptr;
+    }
+    pthread_mutex_init(&q->mutex, nullptr);
+    pthread_cond_init(&q->posted, nullptr);
+    return q;
+}
+
+bool post(Queue queue, uintptr_t key) {
+    auto q = (Keys*)queue;
+    pthread_mutex_lock(&q->mutex);
+    if (q->length == q->capacity) {
+        auto capacity = q->capacity ? q->capacity * 2 : 0x40;
+        auto items = (uintptr_t*)malloc(sizeof(uintptr_t) * capacity);
+        if (items == nullptr) {
+            pthread_mutex_unlock(&q->mutex);
+            return false;
+        }
+        for (auto i = 0; i < q->length; i++) {
+            items[i] = q->items[(q->head + i) % q->capacity];
+        }
+        free(q->items);
+        q->items = items;
+        q->head = 0;
+        q->capacity = capacity;
+    }
+    q->items[(q->head + q->length++) % q->capacity] = key;
+    pthread_cond_signal(&q->posted);
+    pthread_mutex_unlock(&q->mutex);
+    return true;
+}
+
+bool take(Queue queue, uintptr_t &key) {
+    auto q = (Keys*)queue;
+    pthread_mutex_lock(&q->mutex);
+    while (q->length == 0) {
+        pthread_cond_wait(&q->posted, &q->mutex);
+    }
+    key = q->items[q->head];
+    q->head = (q->head + 1) % q->capacity;
+    q->length--;
+    pthread_mutex_unlock(&q->mutex);
+    return true;
+}
+
+void closeQueue(Queue queue) {
+    auto q = (Keys*)queue;
+    pthread_cond_destroy(&q->posted);
+    pthread_mutex_destroy(&q->mutex);
+    free(q->items);
+    free(q);
+}
+
+//----------------------------------------------------------
+void wait(volatile void *address, int32_t expected) {
+    syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+void wakeOne(volatile void *address) {
+    syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+void wakeAll(volatile void *address) {
+    syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+//----------------------------------------------------------
+File openForRead(const char *path, int64_t &size) {
+    auto fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = uint32_t(errno);
+        return invalidFile;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        error = uint32_t(errno);
+        close(fd);
+        return invalidFile;
+    }
+    size = int64_t(st.st_size);
+    return File(fd);
+}
+
+void closeFile(File file) {
+    close(int(file));
+}
+
+uint32_t lastError() {
+    return error;
+}
+
+// What a read keeps in {Read::overlapped}: the iovec of the rest of it, and whether it is done with.
+struct Scratch {
+    iovec    iov;
+    uint64_t isDone;
+};
+static_assert(sizeof(Read::overlapped) >= sizeof(Scratch), "Read::overlapped cannot hold a Scratch");
+
+static Scratch& scratch(Read &r) {
+    return *(Scratch*)r.overlapped;
+}
+
+// Reads the rest of {r} on this thread: where io_uring is missing, or for a read it could not do.
+static void readRest(Read &r) {
+    while (r.transferred < r.length) {
+        auto n = pread(int(r.file), r.buffer + r.transferred, size_t(r.length - r.transferred), r.transferred);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            r.error = n < 0 ? uint32_t(errno) : 0;
+            break;
+        }
+        r.transferred += int(n);
+    }
+    scratch(r).isDone = 1;
+}
+
+/*  An io_uring for one batch of reads, driven through the raw system calls. Each read is an IORING_OP_READV
+*   of its {Scratch::iov}, which every kernel with io_uring (5.1) has.
+*/
+struct Ring {
+    int             fd = -1;
+    io_uring_params params{};
+    void           *sq{}, *cq{};
+    size_t          sqSize{}, cqSize{};
+    io_uring_sqe   *sqes{};
+    size_t          sqesSize{};
+
+    unsigned* sqField(uint32_t offset) const { return (unsigned*)((char*)sq + offset); }
+    unsigned* cqField(uint32_t offset) const { return (unsigned*)((char*)cq + offset); }
+
+    // False where io_uring is missing: before 5.1, or where seccomp or a sysctl turns it off.
+    bool open() {
+        fd = int(syscall(SYS_io_uring_setup, RING_ENTRIES, &params));
+        if (fd < 0) {
+            return false;
+        }
+        sqSize   = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqSize   = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sq   = map(sqSize, IORING_OFF_SQ_RING);
+        cq   = map(cqSize, IORING_OFF_CQ_RING);
+        sqes = (io_uring_sqe*)map(sqesSize, IORING_OFF_SQES);
+        if (sq == nullptr || cq == nullptr || sqes == nullptr) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        unmap(sqes, sqesSize);
+        unmap(cq, cqSize);
+        unmap(sq, sqSize);
+        ::close(fd);
+        fd = -1;
+    }
+
+    /*  Submits {reads}, RING_ENTRIES at most in flight, and queues a read that comes back short again for
+    *   the rest. Returns once nothing is in flight: if the ring fails, the reads it has not done are left
+    *   to the caller, but never one the kernel may still be writing to.
+    */
+    void run(Read *reads, int count) {
+        const auto entries = int(params.sq_entries);
+        Read *again[RING_ENTRIES];
+        auto agains = 0, next = 0;
+        auto pending = 0; // Queued in the ring, not yet taken by the kernel.
+        auto inFlight = 0;
+        auto failed = false;
+        while (inFlight > 0 || (!failed && (pending > 0 || agains > 0 || next < count))) {
+            while (!failed && inFlight + pending < entries && (agains > 0 || next < count)) {
+                queue(agains > 0 ? *again[--agains] : reads[next++]);
+                ++pending;
+            }
+            auto submitted = enter(failed ? 0 : pending, inFlight + pending > 0);
+            if (submitted >= 0) {
+                pending  -= submitted;
+                inFlight += submitted;
+            } else if (failed) {
+                os::yield(); // Still waiting out {inFlight}.
+            } else {
+                failed = true;
+            }
+            reap(again, agains, inFlight);
+        }
+    }
+
+private:
+    void* map(size_t size, uint64_t offset) {
+        auto p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, off_t(offset));
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    static void unmap(void *p, size_t size) {
+        if (p != nullptr) {
+            munmap(p, size);
+        }
+    }
+
+    // Queues the rest of {r}; the caller has checked that there is room.
+    void queue(Read &r) {
+        auto  tail = *sqField(params.sq_off.tail);
+        auto index = tail & *sqField(params.sq_off.ring_mask);
+        auto  &iov = scratch(r).iov;
+        iov.iov_base = r.buffer + r.transferred;
+        iov.iov_len  = size_t(r.length - r.transferred);
+        auto &sqe = sqes[index];
+        memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode    = IORING_OP_READV;
+        sqe.fd        = int(r.file);
+        sqe.addr      = uint64_t(uintptr_t(&iov));
+        sqe.len       = 1;
+        sqe.off       = uint64_t(r.transferred);
+        sqe.user_data = uint64_t(uintptr_t(&r));
+        sqField(params.sq_off.array)[index] = index;
+        __atomic_store_n(sqField(params.sq_off.tail), tail + 1, __ATOMIC_RELEASE);
+    }
+
+    // Submits {submit} queued reads and, if {wait}, waits for a completion. The number taken, or -1.
+    int enter(int submit, bool wait) {
+        for (;;) {
+            auto n = syscall(SYS_io_uring_enter, fd, unsigned(submit), unsigned(wait),
+                             wait ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+            if (n >= 0) {
+                return int(n);
+            }
+            if (errno != EINTR) {
+                return -1;
+            }
+        }
+    }
+
+    void reap(Read **again, int &agains, int &inFlight) {
+        auto  head = *cqField(params.cq_off.head);
+        auto  tail = __atomic_load_n(cqField(params.cq_off.tail), __ATOMIC_ACQUIRE);
+        auto  mask = *cqField(params.cq_off.ring_mask);
+        auto  cqes = (io_uring_cqe*)((char*)cq + params.cq_off.cqes);
+        for (; head != tail; head++) {
+            auto &cqe = cqes[head & mask];
+            auto   &r = *(Read*)uintptr_t(cqe.user_data);
+            --inFlight;
+            if (cqe.res > 0) {
+                r.transferred += cqe.res;
+                if (r.transferred < r.length) {
+                    again[agains++] = &r;
+                } else {
+                    scratch(r).isDone = 1;
+                }
+            } else if (cqe.res == -EINVAL || cqe.res == -EOPNOTSUPP || cqe.res == -EAGAIN) {
+                // Not a read this kernel does through the ring: left to {readRest}.
+            } else {
+                r.error = cqe.res < 0 ? uint32_t(-cqe.res) : 0; // 0: the file got shorter.
+                scratch(r).isDone = 1;
+            }
+        }
+        __atomic_store_n(cqField(params.cq_off.head), head, __ATOMIC_RELEASE);
+    }
+};
+
+/*  All of the reads go to an io_uring at once. Without io_uring, or for a single read, each read is a
+*   pread loop. epoll is no fallback here: regular files are always ready to it, so it cannot wait on
+*   their reads.
+*/
+bool read(Read *reads, int count) {
+    for (auto i = 0; i < count; i++) {
+        reads[i].transferred = 0;
+        reads[i].error = 0;
+        scratch(reads[i]).isDone = 0;
+    }
+    Ring ring{};
+    if (count > 1 && ring.open()) {
+        ring.run(reads, count);
+        ring.close();
+    }
+    auto errors = 0;
+    for (auto i = 0; i < count; i++) {
+        auto &r = reads[i];
+        if (!scratch(r).isDone) {
+            readRest(r);
+        }
+        errors += r.error != 0 || r.transferred < r.length;
+    }
+    return errors == 0;
+}
+} // namespace os
+} // namespace aio
+} // namespace exy
+#endif
\ No newline at end of file
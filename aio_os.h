@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdint.h>
+
+/*  What {aio} needs from the operating system: threads, a queue the pool threads block on, waits on an
+*   address, and batches of file reads. aio_win32.cpp implements it with an I/O completion port, WaitOnAddress
+*   and overlapped reads; aio_linux.cpp with a locked queue, futexes and io_uring. Only standard types appear
+*   here so that each backend builds without the other's headers.
+*/
+namespace exy {
+namespace aio {
+namespace os {
+using Thread   = void*;
+using Queue    = void*;
+using File     = intptr_t;
+using ThreadFn = void (*)(void *param);
+
+constexpr File invalidFile = -1;
+
+int  processors();
+void pause(); // One step of a spin.
+void yield(); // Gives up the rest of this thread's time slice.
+uint32_t threadId();
+
+Thread startThread(ThreadFn fn, void *param); // Null if the thread could not be started.
+bool   joinThreads(Thread *threads, int count);
+void   closeThread(Thread thread);
+
+Queue openQueue(int threads); // Null if it could not be created.
+bool  post(Queue queue, uintptr_t key);
+bool  take(Queue queue, uintptr_t &key); // Blocks until a key is posted.
+void  closeQueue(Queue queue);
+
+// {address} holds a 32-bit integer. {wait} blocks while it equals {expected}, or returns spuriously.
+void wait(volatile void *address, int32_t expected);
+void wakeOne(volatile void *address);
+void wakeAll(volatile void *address);
+
+/*  A read of {length} bytes from the start of {file}. {overlapped} is scratch space for the backend. */
+struct Read {
+    uint64_t overlapped[4];
+    File     file;
+    char    *buffer;
+    int      length;
+    int      transferred;
+    uint32_t error;
+};
+
+File openForRead(const char *path, int64_t &size); // {invalidFile} on failure; see {lastError}.
+void closeFile(File file);
+bool read(Read *reads, int count); // Starts all {reads} at once, then waits for every one of them.
+uint32_t lastError();
+} // namespace os
+} // namespace aio
+} // namespace exy
\ No newline at end of file
@@ -0,0 +1,211 @@
+#include "pch.h"
+
+namespace exy {
+namespace aio {
+namespace os {
+static_assert(sizeof(Read::overlapped) >= sizeof(OVERLAPPED), "Read::overlapped cannot hold an OVERLAPPED");
+
+int processors() {
+    SYSTEM_INFO si{};
+    GetSystemInfo(&si);
+    return int(si.dwNumberOfProcessors);
+}
+
+void pause() {
+    YieldProcessor();
+}
+
+void yield() {
+    SwitchToThread();
+}
+
+uint32_t threadId() {
+    return GetCurrentThreadId();
+}
+
+//----------------------------------------------------------
+struct Start {
+    ThreadFn fn;
+    void    *param;
+};
+
+static DWORD WINAPI start(void *param) {
+    auto s = *(Start*)param;
+    MemFree((Start*)param);
+    s.fn(s.param);
+    return 0;
+}
+
+Thread startThread(ThreadFn fn, void *param) {
+    auto s = MemNew<Start>(fn, param);
+    auto thread = CreateThread(nullptr, 0, start, s, 0, nullptr);
+    if (thread == nullptr) {
+        OsError("CreateThread", nullptr);
+        MemFree(s);
+    }
+    return thread;
+}
+
+bool joinThreads(Thread *threads, int count) {
+    if (WaitForMultipleObjects(DWORD(count), threads, TRUE, INFINITE) != WAIT_OBJECT_0) {
+        OsError("WaitForMultipleObjects", "Expected return value to be '%c#<green>'", "WAIT_OBJECT_0");
+        return false;
+    }
+    return true;
+}
+
+void closeThread(Thread thread) {
+    if (CloseHandle(thread) == FALSE) {
+        OsError("CloseHandle", nullptr);
+    }
+}
+
+//----------------------------------------------------------
+Queue openQueue(int threads) {
+    auto handle = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, DWORD(threads));
+    if (handle == nullptr) {
+        OsError("CreateIoCompletionPort", nullptr);
+    }
+    return handle;
+}
+
+bool post(Queue queue, uintptr_t key) {
+    if (PostQueuedCompletionStatus(queue, 0, ULONG_PTR(key), nullptr) == FALSE) {
+        OsError("PostQueuedCompletionStatus", nullptr);
+        return false;
+    }
+    return true;
+}
+
+bool take(Queue queue, uintptr_t &key) {
+    DWORD bytesTransferred{};
+    ULONG_PTR completionKey{};
+    OVERLAPPED *overlapped{};
+    if (GetQueuedCompletionStatus(queue, &bytesTransferred, &completionKey, &overlapped, INFINITE) == FALSE) {
+        OsError("GetQueuedCompletionStatus", nullptr);
+        return false;
+    }
+    key = uintptr_t(completionKey);
+    return true;
+}
+
+void closeQueue(Queue queue) {
+    if (CloseHandle(queue) == FALSE) {
+        OsError("CloseHandle", nullptr);
+    }
+}
+
+//----------------------------------------------------------
+void wait(volatile void *address, int32_t expected) {
+    WaitOnAddress(address, &expected, sizeof(expected), INFINITE);
+}
+
+void wakeOne(volatile void *address) {
+    WakeByAddressSingle((void*)address);
+}
+
+void wakeAll(volatile void *address) {
+    WakeByAddressAll((void*)address);
+}
+
+//----------------------------------------------------------
+File openForRead(const char *path, int64_t &size) {
+    auto handle = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return invalidFile;
+    }
+    LARGE_INTEGER li{};
+    if (GetFileSizeEx(handle, &li) == FALSE) {
+        auto error = GetLastError();
+        CloseHandle(handle);
+        SetLastError(error);
+        return invalidFile;
+    }
+    size = li.QuadPart;
+    return File(handle);
+}
+
+void closeFile(File file) {
+    CloseHandle(HANDLE(file));
+}
+
+uint32_t lastError() {
+    return GetLastError();
+}
+
+/*  Cancels the reads still in flight and waits for each of them to end, so that the kernel is done with
+*   every buffer before {read} returns. Returns how many of them failed, at least one.
+*/
+static int cancel(Read *reads, int count) {
+    auto errors = 1;
+    for (auto i = 0; i < count; i++) {
+        auto &r = reads[i];
+        if (r.transferred >= 0) {
+            continue;
+        }
+        auto overlapped = (OVERLAPPED*)r.overlapped;
+        CancelIoEx(HANDLE(r.file), overlapped); // Fails if it has completed meanwhile.
+        DWORD transferred{};
+        if (GetOverlappedResult(HANDLE(r.file), overlapped, &transferred, TRUE) == FALSE) {
+            r.error = GetLastError();
+            ++errors;
+        }
+        r.transferred = int(transferred);
+    }
+    return errors;
+}
+
+/*  Every file is bound to a completion port of its own for the batch, so the pool threads never see
+*   these completions. Returns false if any read failed to start or complete; see {Read::error}.
+*/
+bool read(Read *reads, int count) {
+    auto port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+    if (port == nullptr) {
+        OsError("CreateIoCompletionPort", nullptr);
+        return false;
+    }
+    auto errors = 0;
+    auto pending = 0;
+    for (auto i = 0; i < count; i++) {
+        auto &r = reads[i];
+        auto overlapped = (OVERLAPPED*)r.overlapped;
+        *overlapped = {};
+        r.transferred = 0;
+        if (CreateIoCompletionPort(HANDLE(r.file), port, ULONG_PTR(&r), 0) == nullptr) {
+            r.error = GetLastError();
+            ++errors;
+        } else if (ReadFile(HANDLE(r.file), r.buffer, DWORD(r.length), nullptr, overlapped) == FALSE &&
+                   GetLastError() != ERROR_IO_PENDING) {
+            r.error = GetLastError();
+            ++errors;
+        } else {
+            r.transferred = -1; // Until its completion is dequeued.
+            ++pending; // Queued to {port} whether it completed synchronously or not.
+        }
+    }
+    OVERLAPPED_ENTRY entries[0x40];
+    while (pending > 0) {
+        ULONG n{};
+        if (GetQueuedCompletionStatusEx(port, entries, _countof(entries), &n, INFINITE, FALSE) == FALSE) {
+            OsError("GetQueuedCompletionStatusEx", nullptr);
+            errors += cancel(reads, count);
+            break;
+        }
+        for (ULONG i = 0; i < n; i++) {
+            auto &r = *(Read*)entries[i].lpCompletionKey;
+            DWORD transferred{};
+            if (GetOverlappedResult(HANDLE(r.file), (OVERLAPPED*)r.overlapped, &transferred, FALSE) == FALSE) {
+                r.error = GetLastError();
+                ++errors;
+            }
+            r.transferred = int(transferred);
+            --pending;
+        }
+    }
+    CloseHandle(port);
+    return errors == 0;
+}
+} // namespace os
+} // namespace aio
+} // namespace exy
\ No newline at end of file
@@ -0,0 +1,409 @@
+#include "pch.h"
+#include "bench.h"
+
+namespace exy {
+namespace bench {
+using stats::Phase;
+using stats::Counter;
+using stats::microseconds;
+
+static const CHAR *const fanoutTypes[] = {
+    "Int32", "Int64", "UInt32", "UInt64", "Int16", "UInt16", "Int8", "UInt8"
+};
+static const CHAR *const operators[] = { "+", "-", "*" };
+static const CHAR *const leaves[]    = { "a", "b", "1", "2" };
+static const CHAR *const words[]     = {
+    "checks", "the", "bounds", "of", "each", "value", "before", "it", "is", "handed", "back", "to", "caller"
+};
+//----------------------------------------------------------
+// Writes one source tree of {shape}: the same shape always gives the same text.
+struct Generator {
+    const Shape  &shape;
+    FormatStream *stream{};
+    UINT          seed = 0x9E3779B9u;
+    INT           folders{};
+    INT           files{};
+
+    Generator(const Shape &shape) : shape(shape) {}
+
+    UINT next() { // xorshift32
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+
+    bool roll(INT percent) { return INT(next() % 100) < percent; }
+
+    static const CHAR* indent(INT level) {
+        static const CHAR spaces[] = "                                        ";
+        constexpr INT maxLength = _countof(spaces) - 1;
+        return spaces + maxLength - min(level * 4, maxLength);
+    }
+
+    bool folder(const String &path, INT depth) {
+        if (CreateDirectory(path.text, nullptr) == FALSE) {
+            traceln("cannot create folder %s#<red>", &path);
+            return false;
+        }
+        ++folders;
+        auto ok = writeFile(path, -1);
+        for (auto i = 0; ok && i < shape.files; i++) {
+            ok = writeFile(path, i);
+        }
+        for (auto i = 0; ok && depth < shape.depth && i < shape.width; i++) {
+            String subFolder{};
+            subFolder.append(path).append(S("\\m")).appendInt(i);
+            ok = folder(subFolder, depth + 1);
+            subFolder.dispose();
+        }
+        return ok;
+    }
+
+private:
+    // 'main.exy' if {index} is negative; 'f{index}.exy' otherwise.
+    bool writeFile(const String &folderPath, INT index) {
+        String path{};
+        path.append(folderPath).append(S("\\"));
+        if (index < 0) {
+            path.append(S("main"));
+        } else {
+            path.append(S("f")).appendInt(index);
+        }
+        path.append(S(EXY_EXTENSION));
+        auto handle = CreateFile(path.text, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        auto     ok = handle != INVALID_HANDLE_VALUE;
+        if (ok) {
+            FileFormatSink       sink{ handle };
+            BufferedFormatStream buffered{ &sink };
+            stream = &buffered;
+            buffered.lock(); // Flushed a buffer at a time rather than a line at a time.
+            if (index < 0) {
+                main();
+            } else {
+                source(index);
+            }
+            buffered.unlock();
+            stream = nullptr;
+            CloseHandle(handle);
+            ++files;
+        } else {
+            traceln("cannot write %s#<red>", &path);
+        }
+        path.dispose();
+        return ok;
+    }
+
+    void main() {
+        println(stream, "fn main() {");
+        for (auto file = 0; file < shape.files; file++) {
+            if (shape.functions > 0) {
+                println(stream, "%cr%i := f%i_%i(1, 2)", indent(1), file, file, shape.functions - 1);
+            }
+            for (auto i = 0; i < shape.fanout; i++) {
+                println(stream, "%cs%i_%i := t%i_%c(1)", indent(1), file, i, file, fanoutTypes[i]);
+            }
+            for (auto i = 0; i < shape.resumables; i++) {
+                println(stream, "%cw%i_%i := a%i_%i(1)", indent(1), file, i, file, i);
+            }
+        }
+        println(stream, "}");
+    }
+
+    void source(INT file) {
+        for (auto i = 0; i < shape.functions; i++) {
+            function(file, i);
+        }
+        for (auto i = 0; i < shape.resumables; i++) {
+            resumable(file, i);
+        }
+        if (shape.fanout > 0) {
+            // One template, instantiated once per type by the functions below it.
+            comment(0);
+            println(stream, "fn t%i(a, b) {", file);
+            println(stream, "%cif a < b {", indent(1));
+            println(stream, "%creturn a", indent(2));
+            println(stream, "%c}", indent(1));
+            println(stream, "%creturn b", indent(1));
+            println(stream, "}");
+            for (auto i = 0; i < shape.fanout; i++) {
+                println(stream, "fn t%i_%c(a: %c) -> %c = t%i(a, a)", file, fanoutTypes[i], fanoutTypes[i],
+                        fanoutTypes[i], file);
+            }
+        }
+    }
+
+    void function(INT file, INT index) {
+        comment(0);
+        println(stream, "fn f%i_%i(a: Int32, b: Int32) -> Int32 {", file, index);
+        comment(1);
+        print(stream, "%cx := ", indent(1));
+        expression(shape.expressions);
+        println(stream, "");
+        if (shape.lambdas > 0) {
+            lambda(1, 1);
+            println(stream, "%cy := l1(a)", indent(1));
+        } else {
+            println(stream, "%cy := a", indent(1));
+        }
+        comment(1);
+        println(stream, "%cif x > y {", indent(1));
+        if (index > 0) {
+            println(stream, "%creturn f%i_%i(x, y)", indent(2), file, index - 1);
+        } else {
+            println(stream, "%creturn x - y", indent(2));
+        }
+        println(stream, "%c}", indent(1));
+        println(stream, "%creturn y", indent(1));
+        println(stream, "}");
+    }
+
+    // A generator and an async function that awaits it: their bodies are what '--lazy' parses late.
+    void resumable(INT file, INT index) {
+        comment(0);
+        println(stream, "fn g%i_%i(a: Int32) {", file, index);
+        println(stream, "%cyield a", indent(1));
+        println(stream, "%cyield a + 1", indent(1));
+        println(stream, "}");
+        comment(0);
+        println(stream, "fn a%i_%i(a: Int32) {", file, index);
+        println(stream, "%cx := await g%i_%i(a)", indent(1), file, index);
+        println(stream, "}");
+    }
+
+    void expression(INT depth) {
+        if (depth == 0) {
+            print(stream, "%c", leaves[next() % _countof(leaves)]);
+            return;
+        }
+        print(stream, "(");
+        expression(depth - 1);
+        print(stream, " %c ", operators[next() % _countof(operators)]);
+        expression(depth - 1);
+        print(stream, ")");
+    }
+
+    void lambda(INT n, INT level) {
+        comment(level);
+        println(stream, "%cl%i := lambda(x%i: Int32) -> Int32 {", indent(level), n, n);
+        if (n < shape.lambdas) {
+            lambda(n + 1, level + 1);
+            println(stream, "%creturn l%i(x%i) + x%i", indent(level + 1), n + 1, n, n);
+        } else {
+            println(stream, "%creturn x%i + 1", indent(level + 1), n);
+        }
+        println(stream, "%c}", indent(level));
+    }
+
+    void comment(INT level) {
+        if (!roll(shape.comments)) {
+            return;
+        }
+        auto isaBlock = roll(50);
+        print(stream, "%c%c", indent(level), isaBlock ? "/*" : "//");
+        for (auto n = 3 + INT(next() % 8); n > 0; n--) {
+            print(stream, " %c", words[next() % _countof(words)]);
+        }
+        println(stream, isaBlock ? " */" : "");
+    }
+};
+//----------------------------------------------------------
+// Swallows what the compiler traces while it is being measured.
+struct DiscardFormatSink : FormatSink {
+protected:
+    void doWrite(const CHAR*, INT) override {}
+};
+
+void removeFolder(const String &path) {
+    WIN32_FIND_DATA wfd{};
+    String pattern{};
+    pattern.append(path).append(S("\\*"));
+    auto handle = FindFirstFile(pattern.text, &wfd);
+    if (handle != INVALID_HANDLE_VALUE) {
+        do {
+            String itemName{ wfd.cFileName };
+            if (itemName.startsWith(S("."))) {
+                // Do nothing.
+            } else {
+                String itemPath{};
+                itemPath.append(path).append(S("\\")).append(itemName);
+                if ((wfd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0) {
+                    removeFolder(itemPath);
+                } else {
+                    DeleteFile(itemPath.text);
+                }
+                itemPath.dispose();
+            }
+        } while (FindNextFile(handle, &wfd) != FALSE);
+        FindClose(handle);
+    }
+    pattern.dispose();
+    RemoveDirectory(path.text);
+}
+//----------------------------------------------------------
+static INT64 phase(const stats::Snapshot &s, Phase p) { return s.phases[INT(p)]; }
+static INT64 counter(const stats::Snapshot &s, Counter c) { return s.counters[INT(c)]; }
+static INT64 perSecond(INT64 n, INT64 us) { return us > 0 ? n * 1000000 / us : 0; }
+
+// What is reported for each repetition, as p50, p90 and p99 over the repetitions.
+struct Metric {
+    const CHAR *name;
+    const CHAR *unit;
+    INT64     (*of)(const stats::Snapshot&);
+    bool        hundredths; // Whether {of} counts in hundredths of {unit}.
+};
+
+static const Metric metrics[] = {
+    { "build", "µs", [](const stats::Snapshot &s) {
+        return phase(s, Phase::Sources) + phase(s, Phase::Syntax) + phase(s, Phase::Types);
+    }, false },
+    { "lex", "MB/s", [](const stats::Snapshot &s) {
+        return perSecond(counter(s, Counter::Bytes), phase(s, Phase::Tokenize)) / 10000;
+    }, true },
+    { "lex", "tokens/s", [](const stats::Snapshot &s) {
+        return perSecond(counter(s, Counter::Tokens), phase(s, Phase::Tokenize));
+    }, false },
+    { "parse", "nodes/s", [](const stats::Snapshot &s) {
+        return perSecond(counter(s, Counter::SyntaxNodes), phase(s, Phase::Parse));
+    }, false },
+    { "bind", "symbols/s", [](const stats::Snapshot &s) {
+        return perSecond(counter(s, Counter::Symbols), phase(s, Phase::Types));
+    }, false },
+};
+
+// Nearest rank: the smallest value that at least {p} percent of {sorted} are not above.
+static INT64 percentile(const List<INT64> &sorted, INT p) {
+    auto rank = (p * sorted.length + 99) / 100;
+    return sorted.items[max(rank, 1) - 1];
+}
+
+static void report(const Metric &metric, List<INT64> &values) {
+    qsort(values.items, size_t(values.length), sizeof(INT64), [](const void *a, const void *b) {
+        auto x = *(const INT64*)a, y = *(const INT64*)b;
+        return x < y ? -1 : x > y ? 1 : 0;
+    });
+    const INT ps[] = { 50, 90, 99 };
+    trace("  %c#<cyan> %c:", metric.name, metric.unit);
+    for (auto p : ps) {
+        auto value = percentile(values, p);
+        if (metric.hundredths) {
+            trace(" p%i %i64#<green>.%c%i64#<green>", p, value / 100, value % 100 < 10 ? "0" : "", value % 100);
+        } else {
+            trace(" p%i %i64#<green>", p, value);
+        }
+    }
+    traceln("");
+}
+//----------------------------------------------------------
+void parseOptions(Options &options, INT argc, const CHAR **argv) {
+    struct {
+        const CHAR *name;
+        INT        *value;
+        INT         limit;
+    } const numbers[] = {
+        { "--depth",       &options.shape.depth,       6 },
+        { "--width",       &options.shape.width,       8 },
+        { "--files",       &options.shape.files,       64 },
+        { "--functions",   &options.shape.functions,   48 },
+        { "--expressions", &options.shape.expressions, 6 },
+        { "--comments",    &options.shape.comments,    100 },
+        { "--fanout",      &options.shape.fanout,      INT(_countof(fanoutTypes)) },
+        { "--lambdas",     &options.shape.lambdas,     8 },
+        { "--resumables",  &options.shape.resumables,  8 },
+        { "--warmups",     &options.warmups,           100 },
+        { "--repetitions", &options.repetitions,       1000 },
+    };
+    for (auto i = 0; i < argc; i++) {
+        String option{ argv[i] };
+        if (option == String{ S("--keep") }) {
+            options.keep = true;
+            continue;
+        }
+        for (auto &number : numbers) {
+            if (option == String{ number.name } && i + 1 < argc) {
+                *number.value = min(max(atoi(argv[++i]), 0), number.limit);
+                break;
+            }
+        }
+    }
+}
+
+// The 'std' and 'aio' folders next to the compiler are still needed to build the generated tree.
+bool generate(const Shape &shape, String &folder) {
+    auto length = INT(GetTempPath(tmpbufcap, tmpbuf)); // Ends with '\'.
+    folder.append(tmpbuf, length).append(S("exy-bench"));
+    CreateDirectory(folder.text, nullptr); // Fails if it already exists.
+    folder.append(S("\\corpus"));
+    removeFolder(folder); // A previous run may have left a tree of another shape.
+    Generator generator{ shape };
+    auto start = microseconds();
+    auto    ok = generator.folder(folder, 0);
+    traceln("generated %i#<green> folders, %i#<green> files in %s#<yellow> in %i64#<green> µs",
+            generator.folders, generator.files, &folder, microseconds() - start);
+    compiler.config.sourceFolders.append(ids.get(folder));
+    return ok;
+}
+
+/*  Generates a source tree of the given shape and builds all of the trees {warmups} + {repetitions}
+*   times in-process. Only the first build traces anything.
+*/
+INT run(INT argc, const CHAR **argv) {
+    Options options{};
+    parseOptions(options, argc, argv);
+    ids.initialize();
+    auto ok = compiler.config.initialize();
+    String folder{};
+    if (ok) {
+        ok = generate(options.shape, folder);
+    }
+    auto format = stats::format;
+    if (format == stats::Format::None) {
+        stats::format = stats::Format::Table; // Nothing is counted otherwise.
+    }
+    DiscardFormatSink     discard{};
+    List<stats::Snapshot> samples{};
+    stats::Snapshot       snapshot{};
+    for (auto i = 0; ok && i < options.warmups + options.repetitions; i++) {
+        compiler.disposeTrees();
+        stats::snapshot(snapshot); // Forgets the configuration or the previous teardown.
+        auto previous = i > 0 ? redirectConsoleFormatStream(&discard) : nullptr;
+        ok = compiler.build();
+        if (previous != nullptr) {
+            redirectConsoleFormatStream(previous);
+        }
+        stats::snapshot(snapshot);
+        if (i >= options.warmups) {
+            samples.append(snapshot);
+        }
+    }
+    if (!ok) {
+        traceln("benchmark stopped: %i#<red> error%c", compiler.errors, compiler.errors == 1 ? "" : "s");
+    } else if (samples.isNotEmpty()) {
+        auto &last = samples.last();
+        traceln("each build: %i64#<green> files, %i64#<green> B, %i64#<green> tokens, %i64#<green> syntax nodes, %i64#<green> symbols",
+                counter(last, Counter::Files), counter(last, Counter::Bytes), counter(last, Counter::Tokens),
+                counter(last, Counter::SyntaxNodes), counter(last, Counter::Symbols));
+        traceln("%i#<green> warmup%c, %i#<green> repetition%c, %c#<yellow> checks:", options.warmups,
+                options.warmups == 1 ? "" : "s", samples.length, samples.length == 1 ? "" : "s", checks);
+        List<INT64> values{};
+        for (auto &metric : metrics) {
+            values.clear();
+            for (auto i = 0; i < samples.length; i++) {
+                values.append(metric.of(samples.items[i]));
+            }
+            report(metric, values);
+        }
+        values.dispose();
+    }
+    samples.dispose();
+    stats::format = format;
+    auto errors = compiler.errors;
+    compiler.dispose();
+    if (!options.keep && folder.isNotEmpty()) {
+        removeFolder(folder);
+    }
+    folder.dispose();
+    return errors;
+}
+} // namespace bench
+} // namespace exy
\ No newline at end of file
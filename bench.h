@@ -0,0 +1,44 @@
+#pragma once
+
+namespace exy {
+namespace bench {
+// The tier of {EXY_CHECKS} compiled in, so that published numbers say which one they were taken with.
+inline const CHAR *const checks = EXY_CHECKS >= 2 ? "debug" : EXY_CHECKS == 1 ? "hardened" : "release";
+
+// The shape of a generated source tree. Each folder is a module with a 'main.exy' that calls into each
+// of its files, so that everything generated is bound.
+struct Shape {
+    INT depth       = 2;  // Levels of folders below the top-level folder.
+    INT width       = 3;  // Sub-folders in each folder above the deepest level.
+    INT files       = 4;  // Files in each folder, besides 'main.exy'.
+    INT functions   = 16; // In each file; each calls the previous one.
+    INT expressions = 4;  // Depth of the binary expression tree in each function.
+    INT comments    = 25; // Percent of the lines that are preceded by a comment.
+    INT fanout      = 4;  // Builtin types each file's function template is instantiated with.
+    INT lambdas     = 2;  // Depth of the lambdas nested in each function.
+    INT resumables  = 0;  // In each file: generators, each awaited by an async function.
+};
+
+struct Options {
+    Shape shape{};
+    INT   warmups     = 2;
+    INT   repetitions = 10;
+    bool  keep{}; // '--keep': leave the generated source tree on disk.
+};
+
+// exc --bench-corpus [--depth N] [--width N] [--files N] [--functions N] [--expressions N]
+//                    [--comments N] [--fanout N] [--lambdas N] [--resumables N] [--warmups N]
+//                    [--repetitions N] [--keep]
+INT run(INT argc, const CHAR **argv);
+
+void parseOptions(Options &options, INT argc, const CHAR **argv); // Leaves unknown options alone.
+
+// Writes a source tree of {shape} to {folder}, under the temporary folder, and adds it to the top-level
+// source folders.
+bool generate(const Shape &shape, String &folder);
+void removeFolder(const String &path);
+
+// exc --bench-micro [--repetitions N] [--json <path>]
+INT micro(INT argc, const CHAR **argv); // bench_micro.cpp
+} // namespace bench
+} // namespace exy
\ No newline at end of file
@@ -0,0 +1,502 @@
+#include "pch.h"
+#include "bench.h"
+
+namespace exy {
+namespace bench {
+using stats::microseconds;
+
+struct Random {
+    UINT seed;
+
+    UINT next() { // xorshift32
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+};
+
+static INT compareTimes(const void *a, const void *b) {
+    auto x = *(const INT64*)a, y = *(const INT64*)b;
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+//----------------------------------------------------------
+struct Result {
+    const CHAR *name;
+    INT         size;    // Items, keys or bytes, as {name} says.
+    INT         threads;
+    INT64       ops;     // In each repetition.
+    INT64       bytes;   // Hashed in each repetition; 0 unless {name} hashes.
+    INT64       best, median; // Microseconds per repetition.
+
+    INT64 opsPerSecond() const { return best > 0 ? ops * 1000000 / best : 0; }
+};
+
+// Runs each benchmark {repetitions} times and keeps the best and the median time.
+struct Harness {
+    INT          repetitions = 5;
+    List<Result> results{};
+    List<INT64>  times{};
+
+    void dispose() {
+        results.dispose();
+        times.dispose();
+    }
+
+    // Only {body} is timed.
+    template<typename TSetUp, typename TBody, typename TTearDown>
+    void measure(const CHAR *name, INT size, INT threads, INT64 ops, INT64 bytes,
+                 TSetUp setUp, TBody body, TTearDown tearDown) {
+        times.clear();
+        for (auto i = 0; i < repetitions; i++) {
+            setUp();
+            auto start = microseconds();
+            body();
+            times.append(microseconds() - start);
+            tearDown();
+        }
+        qsort(times.items, size_t(times.length), sizeof(INT64), compareTimes);
+        report(results.append(Result{ name, size, threads, ops, bytes, times.items[0], times.items[times.length / 2] }));
+    }
+
+    template<typename TBody>
+    void measure(const CHAR *name, INT size, INT64 ops, TBody body) {
+        measure(name, size, 1, ops, 0, [] {}, body, [] {});
+    }
+
+    static void report(const Result &result) {
+        trace("  %c#<cyan> %i#<green> × %i#<green> thread%c: %i64#<green> ops/s", result.name, result.size,
+              result.threads, result.threads == 1 ? "" : "s", result.opsPerSecond());
+        if (result.bytes > 0 && result.best > 0) {
+            auto hundredths = result.bytes * 100 / result.best; // Bytes per µs is MB/s.
+            trace(", %i64#<green>.%c%i64#<green> MB/s", hundredths / 100, hundredths % 100 < 10 ? "0" : "",
+                  hundredths % 100);
+        }
+        traceln(" (best %i64 µs, median %i64 µs)", result.best, result.median);
+    }
+
+    // One JSON object per line, so that runs can be appended to one file and compared over time.
+    void writeJson(const CHAR *path) {
+        auto handle = CreateFile(path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            traceln("cannot write benchmark results to %c#<red>", path);
+            return;
+        }
+        FileFormatSink       sink{ handle };
+        BufferedFormatStream stream{ &sink };
+        stream.lock(); // Flushed a buffer at a time rather than a line at a time.
+        for (auto i = 0; i < results.length; i++) {
+            auto &result = results.items[i];
+            println(&stream, "{\"benchmark\":\"%c\",\"checks\":\"%c\",\"size\":%i,\"threads\":%i,\"ops\":%i64,"
+                    "\"bytes\":%i64,\"bestUs\":%i64,\"medianUs\":%i64,\"opsPerSecond\":%i64}", result.name, checks,
+                    result.size, result.threads, result.ops, result.bytes, result.best, result.median,
+                    result.opsPerSecond());
+        }
+        stream.unlock();
+        CloseHandle(handle);
+        traceln("benchmark results written to %c#<yellow>", path);
+    }
+};
+//----------------------------------------------------------
+/*  {length} OS threads that each call {body(index)} once {run} signals them. They are created by
+*   {start} and joined by {run}, so that only their work is timed.
+*/
+template<typename TBody>
+struct Crew {
+    static constexpr INT capacity = MAXIMUM_WAIT_OBJECTS;
+
+    struct Member {
+        Crew *crew;
+        INT   index;
+    };
+    TBody  &body;
+    HANDLE  go{};
+    HANDLE  handles[capacity]{};
+    Member  members[capacity]{};
+    INT     length{};
+
+    Crew(TBody &body) : body(body) {}
+
+    void start(INT n) {
+        Check(n > 0 && n <= capacity);
+        go = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+        for (length = 0; length < n; length++) {
+            members[length] = { this, length };
+            handles[length] = CreateThread(nullptr, 0, main, &members[length], 0, nullptr);
+            Assert(handles[length] != nullptr);
+        }
+    }
+
+    void run() {
+        SetEvent(go);
+        WaitForMultipleObjects(DWORD(length), handles, TRUE, INFINITE);
+    }
+
+    void stop() {
+        for (auto i = 0; i < length; i++) {
+            CloseHandle(handles[i]);
+        }
+        CloseHandle(go);
+        length = 0;
+    }
+
+    static DWORD WINAPI main(void *arg) {
+        auto member = (Member*)arg;
+        WaitForSingleObject(member->crew->go, INFINITE);
+        member->crew->body(member->index);
+        return 0;
+    }
+};
+
+static INT maxThreads() {
+    SYSTEM_INFO si{};
+    GetSystemInfo(&si);
+    return min(INT(si.dwNumberOfProcessors), INT(MAXIMUM_WAIT_OBJECTS));
+}
+//----------------------------------------------------------
+/*  Identifier-like keys: a few short names, then camel case names made of a verb and a noun with a
+*   number once those run out. Looked up with a skew towards the first ones, as names are in source.
+*/
+struct Keys {
+    Mem          mem{};
+    List<String> items{};
+    Random       random{ 0x2545F491u };
+
+    void initialize(INT n) {
+        static const CHAR *const shortNames[] = { "i", "j", "k", "n", "x", "y", "a", "b", "it", "id", "fn", "op" };
+        static const CHAR *const verbs[]      = { "", "is", "get", "set", "make", "bind", "parse", "to" };
+        static const CHAR *const nouns[]      = {
+            "Node", "Symbol", "Type", "Scope", "Token", "File", "Module", "Item",
+            "Value", "Name", "Index", "Length", "Pos", "Syntax", "Cast", "Template"
+        };
+        constexpr INT shorts = _countof(shortNames);
+        constexpr INT combinations = _countof(verbs) * _countof(nouns);
+        Dict<INT> hashes{};
+        for (auto i = 0; items.length < n; i++) {
+            String name{};
+            if (i < shorts) {
+                name.append(String{ shortNames[i] });
+            } else {
+                auto j = i - shorts;
+                name.append(String{ verbs[j % _countof(verbs)] });
+                name.append(String{ nouns[(j / _countof(verbs)) % _countof(nouns)] });
+                if (j >= combinations) {
+                    name.appendInt(j / combinations);
+                }
+            }
+            auto hash = hash32(name.text, name.length);
+            if (hash != 0 && hash != Dict<INT>::nullHash && !hashes.contains(hash)) {
+                hashes.append(hash, i); // {Dict} takes a hash only once.
+                auto text = mem.alloc<CHAR>(name.length + 1);
+                MemCopy(text, name.text, name.length);
+                text[name.length] = '\0';
+                items.append(String{ text, name.length, hash });
+            }
+            name.dispose();
+        }
+        hashes.dispose();
+    }
+
+    void dispose() {
+        items.dispose();
+        mem.dispose();
+    }
+
+    // The index of a key among the first {n}, favouring the first ones.
+    INT sample(INT n) {
+        auto r = UINT64(random.next() % UINT(n));
+        return INT(r * r / UINT64(n));
+    }
+};
+//----------------------------------------------------------
+struct Placed {
+    INT   a, b;
+    void *c;
+};
+
+static void benchLists(Harness &harness) {
+    const INT appendSizes[] = { 16, 1024, 65536 };
+    for (auto size : appendSizes) {
+        auto rounds = max(0x40000 / size, 1);
+        harness.measure("list.append", size, INT64(size) * rounds, [=] {
+            for (auto r = 0; r < rounds; r++) {
+                List<INT> list{};
+                for (auto i = 0; i < size; i++) {
+                    list.append(i);
+                }
+                list.dispose();
+            }
+        });
+        harness.measure("list.place", size, INT64(size) * rounds, [=] {
+            for (auto r = 0; r < rounds; r++) {
+                List<Placed> list{};
+                for (auto i = 0; i < size; i++) {
+                    list.place(i, i, nullptr);
+                }
+                list.dispose();
+            }
+        });
+    }
+    // At the front, where each one moves every item.
+    const INT moveSizes[] = { 16, 256, 4096 };
+    for (auto size : moveSizes) {
+        auto rounds = max(0x10000 / size, 1);
+        harness.measure("list.insert", size, INT64(size) * rounds, [=] {
+            for (auto r = 0; r < rounds; r++) {
+                List<INT> list{};
+                for (auto i = 0; i < size; i++) {
+                    list.insert(i, 0);
+                }
+                list.dispose();
+            }
+        });
+        List<List<INT>> lists{};
+        harness.measure("list.erase", size, 1, INT64(size) * rounds, 0, [&] {
+            for (auto r = 0; r < rounds; r++) {
+                auto &list = lists.append(List<INT>{});
+                for (auto i = 0; i < size; i++) {
+                    list.append(i);
+                }
+            }
+        }, [&] {
+            for (auto r = 0; r < rounds; r++) {
+                auto &list = lists.items[r];
+                while (list.isNotEmpty()) {
+                    list.erase(0, 1);
+                }
+            }
+        }, [&] {
+            lists.clear([](auto &list) { list.dispose(); });
+        });
+        lists.dispose();
+    }
+}
+
+static void benchDicts(Harness &harness, Keys &keys) {
+    const INT sizes[] = { 64, 1024, 16384 };
+    for (auto size : sizes) {
+        Assert(size <= keys.items.length);
+        auto rounds = max(0x40000 / size, 1);
+        harness.measure("dict.append", size, INT64(size) * rounds, [&, size, rounds] {
+            for (auto r = 0; r < rounds; r++) {
+                Dict<INT> dict{};
+                for (auto i = 0; i < size; i++) {
+                    dict.append(keys.items.items[i].hash, i);
+                }
+                dict.dispose();
+            }
+        });
+        Dict<INT> dict{};
+        List<UINT> hits{}, misses{};
+        for (auto i = 0; i < size; i++) {
+            dict.append(keys.items.items[i].hash, i);
+        }
+        for (auto i = 0; i < 0x40000; i++) {
+            hits.append(keys.items.items[keys.sample(size)].hash);
+        }
+        for (auto i = 0; misses.length < 0x40000; i++) {
+            misses.append(keys.items.items[size + i % (keys.items.length - size)].hash);
+        }
+        volatile INT found = 0;
+        harness.measure("dict.indexOf.hit", size, hits.length, [&] {
+            auto n = 0;
+            for (auto i = 0; i < hits.length; i++) {
+                n += dict.indexOf(hits.items[i]) >= 0;
+            }
+            found = n;
+        });
+        harness.measure("dict.indexOf.miss", size, misses.length, [&] {
+            auto n = 0;
+            for (auto i = 0; i < misses.length; i++) {
+                n += dict.indexOf(misses.items[i]) >= 0;
+            }
+            found = n;
+        });
+        misses.dispose();
+        hits.dispose();
+        dict.dispose();
+    }
+}
+
+static void benchIdentifiers(Harness &harness, Keys &keys) {
+    constexpr INT keyCount = 4096;
+    constexpr INT hitsPerThread = 0x20000;
+    constexpr INT missesPerThread = 0x2000;
+    Assert(keyCount <= keys.items.length);
+    for (auto i = 0; i < keyCount; i++) {
+        ids.get(keys.items.items[i]);
+    }
+    static volatile LONG repetition = 0; // Makes each repetition's misses new names.
+    auto hit = [&](INT) {
+        Random random{ 0x9E3779B9u };
+        for (auto i = 0; i < hitsPerThread; i++) {
+            auto r = UINT64(random.next() % UINT(keyCount));
+            ids.get(keys.items.items[INT(r * r / keyCount)]);
+        }
+    };
+    auto miss = [&](INT index) {
+        CHAR name[0x40] = "key`";
+        auto prefix = 4;
+        _itoa_s(INT(repetition), name + prefix, _countof(name) - prefix, 36);
+        prefix = cstrlen(name);
+        name[prefix++] = '`';
+        _itoa_s(index, name + prefix, _countof(name) - prefix, 36);
+        prefix = cstrlen(name);
+        name[prefix++] = '`';
+        for (auto i = 0; i < missesPerThread; i++) {
+            _itoa_s(i, name + prefix, _countof(name) - prefix, 36);
+            ids.get(name, cstrlen(name));
+        }
+    };
+    Crew<decltype(hit)>  hitters{ hit };
+    Crew<decltype(miss)> missers{ miss };
+    for (auto threads = 1; threads <= maxThreads(); threads *= 2) {
+        harness.measure("ids.get.hit", keyCount, threads, INT64(threads) * hitsPerThread, 0,
+                        [&] { hitters.start(threads); }, [&] { hitters.run(); }, [&] { hitters.stop(); });
+        harness.measure("ids.get.miss", keyCount, threads, INT64(threads) * missesPerThread, 0, [&] {
+            InterlockedIncrement(&repetition);
+            missers.start(threads);
+        }, [&] { missers.run(); }, [&] { missers.stop(); });
+    }
+}
+
+static void benchMem(Harness &harness) {
+    struct Mix {
+        const CHAR *name;
+        INT         count;
+        INT         minSize, maxSize;
+        INT         bigEvery; // Every so many, a 4 KiB allocation; 0 for none.
+    };
+    const Mix mixes[] = {
+        { "mem.alloc.small", 0x40000, 8,    64,    0  },
+        { "mem.alloc.mixed", 0x40000, 8,    256,   64 },
+        { "mem.alloc.large", 0x1000,  1024, 16384, 0  },
+    };
+    for (auto &mix : mixes) {
+        List<INT> sizes{};
+        Random random{ 0x2545F491u };
+        for (auto i = 0; i < mix.count; i++) {
+            if (mix.bigEvery > 0 && i % mix.bigEvery == 0) {
+                sizes.append(4096);
+            } else {
+                sizes.append(mix.minSize + INT(random.next() % UINT(mix.maxSize - mix.minSize + 1)));
+            }
+        }
+        Mem mem{};
+        harness.measure(mix.name, mix.count, 1, mix.count, 0, [] {}, [&] {
+            for (auto i = 0; i < sizes.length; i++) {
+                mem.alloc<CHAR>(sizes.items[i]);
+            }
+        }, [&] {
+            mem.dispose();
+        });
+        sizes.dispose();
+    }
+}
+
+// Keeps 16 blocks alive, replacing one per round.
+static void churn(UINT seed, INT rounds) {
+    void  *live[16]{};
+    Random random{ seed };
+    for (auto i = 0; i < rounds; i++) {
+        auto &slot = live[i & 15];
+        heap::free(slot);
+        slot = heap::alloc(16 + INT(random.next() % 240));
+    }
+    for (auto &slot : live) {
+        heap::free(slot);
+    }
+}
+
+struct HeapWork {
+    UINT seed;
+};
+
+struct HeapWorker {
+    INT rounds;
+    void run(HeapWork *work) { churn(work->seed, rounds); }
+};
+
+static void benchHeap(Harness &harness) {
+    constexpr INT rounds = 0x4000;
+    auto threads = aio::threads() + 1; // The pool helps the calling thread.
+    auto   items = threads * 4;
+    List<HeapWork>  work{};
+    List<HeapWork*> workList{};
+    for (auto i = 0; i < items; i++) {
+        work.append(HeapWork{ UINT(0x2545F491u + i) });
+    }
+    for (auto i = 0; i < items; i++) {
+        workList.append(&work.items[i]);
+    }
+    HeapWorker worker{ rounds };
+    harness.measure("heap.alloc_free", items, INT64(items) * rounds, [&] {
+        for (auto i = 0; i < workList.length; i++) {
+            worker.run(workList.items[i]);
+        }
+    });
+    harness.measure("heap.alloc_free", items, threads, INT64(items) * rounds, 0,
+                    [] {}, [&] { aio::run(worker, workList); }, [] {});
+    workList.dispose();
+    work.dispose();
+}
+
+static void benchHash(Harness &harness) {
+    const INT lengths[] = { 4, 8, 16, 32, 64, 256, 1024, 4096 };
+    constexpr INT bytesPerRepetition = 0x1000000;
+    constexpr INT dataLength = 4096 + 8; // Hashed from each of the first 8 offsets in turn.
+    CHAR  *data = MemAlloc<CHAR>(dataLength);
+    Random random{ 0x9E3779B9u };
+    for (auto i = 0; i < dataLength; i++) {
+        data[i] = CHAR(random.next());
+    }
+    volatile UINT sink = 0;
+    for (auto length : lengths) {
+        auto rounds = bytesPerRepetition / length;
+        harness.measure("hash32", length, 1, rounds, INT64(rounds) * length, [] {}, [&] {
+            UINT h = 0;
+            for (auto i = 0; i < rounds; i++) {
+                h ^= hash32(data + (i & 7), length);
+            }
+            sink = h;
+        }, [] {});
+    }
+    MemFree(data);
+}
+//----------------------------------------------------------
+/*  Times the containers and allocators every phase of the compiler is built on, one benchmark at a
+*   time on an otherwise idle process. Prints a table; '--json <path>' also writes the results as
+*   one JSON object per line.
+*/
+INT micro(INT argc, const CHAR **argv) {
+    Harness     harness{};
+    const CHAR *jsonPath = nullptr;
+    for (auto i = 0; i < argc; i++) {
+        String option{ argv[i] };
+        if (option == String{ S("--repetitions") } && i + 1 < argc) {
+            harness.repetitions = min(max(atoi(argv[++i]), 1), 1000);
+        } else if (option == String{ S("--json") } && i + 1 < argc) {
+            jsonPath = argv[++i];
+        }
+    }
+    ids.initialize();
+    Keys keys{};
+    keys.initialize(0x8000);
+    traceln("%i#<green> repetition%c of each, %c#<yellow> checks:", harness.repetitions,
+            harness.repetitions == 1 ? "" : "s", checks);
+    benchLists(harness);
+    benchDicts(harness, keys);
+    benchIdentifiers(harness, keys);
+    benchMem(harness);
+    benchHeap(harness);
+    benchHash(harness);
+    if (jsonPath != nullptr) {
+        harness.writeJson(jsonPath);
+    }
+    keys.dispose();
+    harness.dispose();
+    ids.dispose();
+    return 0;
+}
+} // namespace bench
+} // namespace exy
\ No newline at end of file
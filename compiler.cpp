@@ -9,27 +9,60 @@ namespace exy {
 void Compiler::run() {
     traceln("Starting compiler");
     ids.initialize();
-    if (compiler.config.initialize()) {
-        compiler.sourceTree = MemNew<SourceTree>();
-        if (compiler.sourceTree->initialize()) {
-            compiler.syntaxTree = MemNew<SyntaxTree>();
-            if (compiler.syntaxTree->initialize()) {
-                compiler.tpTree = MemNew<TpTree>();
-                if (compiler.tpTree->initialize()) {
-
-                }
-            }
+    auto ok = false;
+    {
+        stats::Timer timer{ stats::Phase::Configure };
+        ok = compiler.config.initialize();
+    }
+    if (ok) {
+        compiler.build();
+    }
+    compiler.summarizeErrors();
+    stats::sampleArenas();
+    stats::writeEvents();
+    {
+        stats::Timer timer{ stats::Phase::Teardown };
+        compiler.dispose();
+    }
+    stats::report();
+}
+
+// Builds whichever of the source, syntax and typed trees are missing. A resident
+// server disposes only what is stale and calls this again for the next request.
+bool Compiler::build() {
+    if (sourceTree == nullptr) {
+        stats::Timer timer{ stats::Phase::Sources };
+        sourceTree = MemNew<SourceTree>();
+        if (!sourceTree->initialize()) {
+            return false;
+        }
+    }
+    if (syntaxTree == nullptr) {
+        stats::Timer timer{ stats::Phase::Syntax };
+        syntaxTree = MemNew<SyntaxTree>();
+        if (!syntaxTree->initialize()) {
+            return false;
+        }
+    }
+    if (tpTree == nullptr) {
+        stats::Timer timer{ stats::Phase::Types };
+        tpTree = MemNew<TpTree>();
+        if (!tpTree->initialize()) {
+            return false;
         }
     }
-    compiler.dispose();
+    return errors == 0;
 }
 
-void Compiler::dispose() {
-    traceln("Stopping compiler");
+void Compiler::disposeTypedTree() {
     if (tpTree != nullptr) {
         tpTree->dispose();
         tpTree = MemFree(tpTree);
     }
+}
+
+void Compiler::disposeTrees() {
+    disposeTypedTree();
     if (syntaxTree != nullptr) {
         syntaxTree->dispose();
         syntaxTree = MemFree(syntaxTree);
@@ -38,6 +71,11 @@ void Compiler::dispose() {
         sourceTree->dispose();
         sourceTree = MemFree(sourceTree);
     }
+}
+
+void Compiler::dispose() {
+    traceln("Stopping compiler");
+    disposeTrees();
     config.dispose();
     ids.dispose();
 }
@@ -139,17 +177,28 @@ void Compiler::error(const CHAR *cppFile, const CHAR *cppFunc, INT cppLine,
 void Compiler::error(const CHAR *cppFile, const CHAR *cppFunc, INT cppLine, 
                      const CHAR *pass, const SourceFile *file, const SourceChar *start,
                      const SourceChar *end, const CHAR *msg, va_list ap) {
-    ++errors;
+    // Binders on other threads may report errors at the same time.
+    auto number = InterlockedIncrement((volatile LONG*)&errors);
     if (pass == nullptr) {
         pass = "Compiler";
     }
+    if (diagnostics::format != diagnostics::Format::None) {
+        return diagnostics::write(number, pass, file, start, end, cppFile, cppFunc, cppLine, msg, ap);
+    }
+    if (config.maxErrors > 0 && number > config.maxErrors) {
+        return; // Counted but not shown: see {summarizeErrors}.
+    }
     if (file == nullptr) {
         return error(cppFile, cppFunc, cppLine, pass, msg, ap);
     }
     Assert(*start <= *end);
+    // Written at once however many lines it takes, so that an error does not interleave with one
+    // reported by another thread and a run of errors is not a run of small writes.
+    auto stream = getConsoleFormatStream();
+    stream->lock();
     // '#' error-number '.' file-name '(' start-pos ':' end-pos ')' ':' error-type '→' message
     // highlight
-    trace("\r\n#%i#<red>. %s#<yellow underline>(", errors, file->dotName);
+    trace("\r\n#%i#<red>. %s#<yellow underline>(", INT(number), file->dotName);
     if (start->line == end->line) {
         if (start->col == end->col) {
             trace("%i#<yellow>:%i#<yellow>", start->line, start->col);
@@ -172,6 +221,21 @@ void Compiler::error(const CHAR *cppFile, const CHAR *cppFunc, INT cppLine,
     }
     traceln("  %c#<darkyellow> @ %c#<darkyellow>:%i#<darkyellow>", cppFile, cppFunc, cppLine);
     graph(maxLineNumberLength);
+    stream->unlock();
+}
+
+// Says how many errors were counted but not shown because of '--max-errors', or where they were written.
+void Compiler::summarizeErrors() {
+    if (diagnostics::format != diagnostics::Format::None) {
+        if (errors > 0) {
+            traceln("\r\n%i#<red> error%c written to %c#<yellow>", errors, errors == 1 ? "" : "s", diagnostics::path);
+        }
+        return;
+    }
+    auto hidden = errors - config.maxErrors;
+    if (config.maxErrors > 0 && hidden > 0) {
+        traceln("\r\n%i#<red> more error%c not shown: see '--max-errors'", hidden, hidden == 1 ? "" : "s");
+    }
 }
 
 void Compiler::error(const CHAR *, const CHAR *, INT , 
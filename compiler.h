@@ -19,6 +19,12 @@ struct Compiler {
 
     static void run();
 
+    bool build();
+    void disposeTypedTree();
+    void disposeTrees();
+    void dispose();
+    void summarizeErrors();
+
     void error(const CHAR *cppFile, const CHAR *cppFunc, INT cppLine,
                const CHAR *pass, const SourceFile&, const SourceRange&, const CHAR *msg, ...);
     void error(const CHAR *cppFile, const CHAR *cppFunc, INT cppLine, 
@@ -37,8 +43,6 @@ struct Compiler {
                const CHAR *pass, const TpSymbol*, const CHAR *msg, ...);
 
 private:
-    void dispose();
-
     void error(const CHAR *cppFile, const CHAR *cppFunc, INT cppLine, 
                const CHAR *pass, const SourceFile*, const SourceChar *start, const SourceChar *end,
                const CHAR *msg, va_list ap);
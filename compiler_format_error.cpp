@@ -5,125 +5,30 @@
 
 namespace exy {
 struct Line {
-    using Pos = const CHAR*;
-
-    Pos start;
-    Pos end;
-    INT line;
-
-    Line previousLine(Pos srcStart) const {
-        Line ln{ nullptr, nullptr, line - 1 };
-        if (ln.line == 0) {
-            return ln;
-        }
-        ln.end = start - 1;
-        Assert(ln.end >= srcStart && *ln.end == '\n');
-        if (ln.end > srcStart && ln.end[-1] == '\r') {
-            --ln.end;
-        }
-        ln.start = ln.end;
-        if (ln.start > srcStart) {
-            for (--ln.start; ln.start > srcStart; --ln.start) {
-                if (*ln.start == '\n') {
-                    ++ln.start;
-                    break;
-                }
-            }
-        }
-        return ln;
-    }
-
-    Line nextLine(Pos srcEnd, INT maxLines) const {
-        Line ln{ nullptr, nullptr, line + 1 };
-        if (ln.line > maxLines) {
-            ln.line = 0;
-            return ln;
-        }
-        if (*end == '\r' && end[1] == '\n') {
-            ln.start = end + 2;
-        } else if (*end == '\n') {
-            ln.start = end + 1;
-        } else {
-            Assert(0);
-        }
-        Assert(ln.start <= srcEnd);
-        ln.end = ln.start;
-        if (ln.end < srcEnd && *ln.end != '\n') {
-            for (++ln.end; ln.end < srcEnd; ++ln.end) {
-                if (*ln.end == '\n') {
-                    if (ln.end[-1] == '\r') {
-                        --ln.end;
-                    }
-                    break;
-                }
-            }
-        }
-        return ln;
-    }
+    const CHAR *start;
+    const CHAR *end;
+    INT         line;
 
     auto isEmpty() const {
         return start == end;
     }
-
-    auto isNewLine() const {
-        auto length = INT(end - start);
-        if (length == 2 && *start == '\r' && end[1] == '\n') {
-            return true;
-        }
-        if (length == 1 && *start == '\n') {
-            return true;
-        }
-        return false;
-    }
 };
 
-static auto makeLine(const CHAR *srcStart, const CHAR *hotPos, INT line, const CHAR *srcEnd) {
-    Line ln{ hotPos, hotPos, line };
-    for (; ln.start > srcStart; --ln.start) {
-        if (*ln.start == '\n') {
-            break;
-        }
-    }
-    if (ln.start > srcStart && ln.start < hotPos) {
-        ++ln.start;
-    }
-    for (; ln.end < srcEnd; ++ln.end) {
-        if (*ln.end == '\n') {
-            break;
-        }
-    }
-    if (ln.end < srcEnd && ln.end > hotPos) {
-        if (ln.end - 1 >= srcStart && ln.end[-1] == '\r') {
-            --ln.end;
-        }
-    }
-    return ln;
+// Found through {SourceFile::lineStarts}, so that it costs the same however long the file or the line.
+static auto makeLine(const SourceFile *file, INT line) {
+    auto text = file->lineAt(line);
+    return Line{ text.start(), text.end(), line };
 }
 constexpr auto maxLinesBefore = 3;
 constexpr  auto maxLinesAfter = 2;
 static thread_local Line lines[maxLinesBefore + 1 + maxLinesAfter]{};
 
-static auto makeLines(const CHAR *srcStart, const Line &hotLine, const CHAR *srcEnd, INT maxLines) {
-    Line lns[maxLinesBefore]{};
-    auto length = 0;
-    for (auto i = 0; i < maxLinesBefore; ++i) {
-        auto ln = length > 0 ? lns[length - 1].previousLine(srcStart) : hotLine.previousLine(srcStart);
-        if (ln.line == 0) {
-            break;
-        }
-        lns[length++] = ln;
-    }
+static auto makeLines(const SourceFile *file, INT hotLine) {
+    const auto first = max(hotLine - maxLinesBefore, 1);
+    const auto  last = min(hotLine + maxLinesAfter, file->lines);
     auto j = 0;
-    for (auto i = length; --i >= 0; ) {
-        lines[j++] = lns[i];
-    }
-    lines[j++] = hotLine;
-    for (auto i = 0; i < maxLinesAfter; i++) {
-        auto ln = lines[j - 1].nextLine(srcEnd, maxLines);
-        if (ln.line == 0) {
-            break;
-        }
-        lines[j++] = ln;
+    for (auto line = first; line <= last; line++) {
+        lines[j++] = makeLine(file, line);
     }
     return j;
 }
@@ -140,6 +45,8 @@ static auto parseHotLine(const Line &ln, const CHAR *hotStart, const CHAR *hotEn
     HotLine hot{ ln.start, hotStart, hotEnd, ln.end, false };
     if (hot.start < hot.lnStart) {
         hot.start = hot.lnStart;
+    } else if (hot.start > hot.lnEnd) {
+        hot.start = hot.lnEnd; // At the line break.
     }
     if (hot.end > hot.lnEnd) {
         hot.end = hot.lnEnd;
@@ -149,6 +56,9 @@ static auto parseHotLine(const Line &ln, const CHAR *hotStart, const CHAR *hotEn
 }
 
 INT Compiler::highlight(const SourceFile *file, const SourceChar *hotStart, const SourceChar *hotEnd) {
+    if (file->lineStarts.isEmpty()) {
+        return 0; // Not tokenized.
+    }
     const auto     &src = file->source;
     const auto srcStart = src.start();
     const auto   srcEnd = src.end();
@@ -159,8 +69,8 @@ INT Compiler::highlight(const SourceFile *file, const SourceChar *hotStart, cons
     if (hotStart->line == hotEnd->line) {
         Assert(hotStart->col <= hotEnd->col);
     }
-    const auto hotLine = makeLine(srcStart, hotStart->text, hotStart->line, srcEnd);
-    const auto     lns = makeLines(srcStart, hotLine, srcEnd, file->lines);
+    const auto hotLine = makeLine(file, hotStart->line);
+    const auto     lns = makeLines(file, hotStart->line);
     Assert(lns > 0);
 
     auto maxLineNumberLength = 0;
@@ -192,7 +102,7 @@ INT Compiler::highlight(const SourceFile *file, const SourceChar *hotStart, cons
         } else {
             trace("%i#<darkgreen>  %c#<green>", ln.line, "|");
         }
-        if (ln.isNewLine() || ln.isEmpty()) {
+        if (ln.isEmpty()) {
             // Do nothing.
         } else if (ln.line == hotLine.line) {
             auto hot = parseHotLine(ln, hotStart->text, hotEnd->text);
@@ -259,7 +169,7 @@ void Compiler::graph(INT indent) {
         if (hotStart.line == hotEnd.line) {
             Assert(hotStart.col <= hotEnd.col);
         }
-        const auto line = makeLine(srcStart, hotStart.text, hotStart.line, srcEnd);
+        const auto line = makeLine(&file, hotStart.line);
         // fileName(line:col) source
         const auto fileName = file.dotName;
         if (fileName->length > maxGraphFileNameLength) {
@@ -1,6 +1,46 @@
 #include "pch.h"
 
 namespace exy {
+void Configuration::parseOptions(INT argc, const CHAR **argv, bool isRequest) {
+    for (auto i = 1; i < argc; i++) {
+        String option{ argv[i] };
+        if (option == String{ S("--lazy") }) {
+            lazyFunctionBodies = true;
+        } else if (option == String{ S("--parallel") }) {
+            parallelBinding = true;
+        } else if (option == String{ S("--max-errors") } && i + 1 < argc) {
+            maxErrors = max(atoi(argv[++i]), 0);
+        } else if (isRequest) {
+            // The rest set up the process: a request cannot change them.
+        } else if (option == String{ S("--threads") } && i + 1 < argc) {
+            threads = max(atoi(argv[++i]), 0);
+        } else if (option == String{ S("--stats") }) {
+            stats::format = stats::Format::Table;
+        } else if (option == String{ S("--stats=json") }) {
+            stats::format = stats::Format::Json;
+        } else if (option == String{ S("--diagnostics=json") } && i + 1 < argc) {
+            diagnostics::format = diagnostics::Format::Json;
+            diagnostics::path   = argv[++i];
+        } else if (option == String{ S("--diagnostics=sarif") } && i + 1 < argc) {
+            diagnostics::format = diagnostics::Format::Sarif;
+            diagnostics::path   = argv[++i];
+        } else if (option == String{ S("--trace-events") } && i + 1 < argc) {
+            stats::eventsPath = argv[++i];
+        } else if (option == String{ S("--log") } && i + 1 < argc) {
+            if (!setTraceLevels(argv[++i])) {
+                traceln("unknown log levels: %c#<red>", argv[i]);
+            }
+        }
+    }
+}
+
+void Configuration::resetOptions() {
+    const Configuration defaults{};
+    lazyFunctionBodies = defaults.lazyFunctionBodies;
+    parallelBinding    = defaults.parallelBinding;
+    maxErrors          = defaults.maxErrors;
+}
+
 bool Configuration::initialize() {
     traceln("Finding top-level source folders...");
     if (setCompilerFolder()) {
@@ -4,7 +4,16 @@ namespace exy {
 struct Configuration {
     Identifier       compilerFolderName{};
     List<Identifier> sourceFolders{};
+    bool             lazyFunctionBodies{}; // '--lazy': parse a function's body when it is first bound.
+    bool             parallelBinding{};    // '--parallel': bind modules concurrently on the aio threads.
+    INT              threads{};            // '--threads N': size of the aio thread pool; 0 sizes it by core count.
+    INT              maxErrors = 100;      // '--max-errors N': how many errors are shown; the rest are only counted. 0 shows all.
 
+    /*  {argv[0]} is the program. With {isRequest}, only the options a resident server takes per
+    *   request are parsed ('--lazy', '--parallel', '--max-errors'); the others are process-wide.
+    */
+    void parseOptions(INT argc, const CHAR **argv, bool isRequest = false);
+    void resetOptions(); // Back to the defaults of the options a request may set.
     bool initialize();
     void dispose();
 
@@ -44,63 +44,160 @@ void FormatStream::write(const String *s) {
 static thread_local CHAR fmtbuf[0x1000]{};
 constexpr auto fmtbufcap = (INT)__crt_countof(fmtbuf);
 
-struct ConsoleFormatStream : FormatStream {
-	static SRWLOCK srw;
-	static thread_local INT locks;
-	static bool initialized;
+//----------------------------------------------------------
+void FormatSink::write(const CHAR *v, INT vlen) {
+	Assert(vlen >= 0);
+	if (v == nullptr || vlen == 0) {
+		return;
+	}
+	AcquireSRWLockExclusive(&srw);
+	doWrite(v, vlen);
+	ReleaseSRWLockExclusive(&srw);
+}
 
-	void lock() override {
-		Assert(locks >= 0);
-		if (++locks == 1) {
-			AcquireSRWLockExclusive(&srw);
-		}
+void ConsoleFormatSink::initialize() {
+	// Called under {srw}.
+	DWORD consoleMode = 0;
+	if (GetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), &consoleMode) != FALSE) {
+		SetConsoleCP(CP_UTF8);
+		SetConsoleOutputCP(CP_UTF8);
+		mode = Mode::Console;
+	} else {
+		mode = Mode::Redirected; // To a file or a pipe: {WriteConsole} would fail.
 	}
-	void unlock() override {
-		Assert(locks > 0);
-		if (--locks == 0) {
-			ReleaseSRWLockExclusive(&srw);
-		}
+}
+
+bool ConsoleFormatSink::isaTerminal() const {
+	if (mode == Mode::Unknown) {
+		DWORD consoleMode = 0;
+		return GetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), &consoleMode) != FALSE;
 	}
-	void doWrite(const CHAR *v, INT vlen) override {
-		Assert(vlen >= 0);
-		if (v == nullptr || vlen == 0) {
-			return;
-		}
-		auto handle = GetStdHandle(STD_OUTPUT_HANDLE);
-		if (!initialized) {
-			SetConsoleCP(CP_UTF8);
-			SetConsoleOutputCP(CP_UTF8);
-			initialized = true;
-		}
-		DWORD bytesWritten = 0;
+	return mode == Mode::Console;
+}
+
+void ConsoleFormatSink::doWrite(const CHAR *v, INT vlen) {
+	if (mode == Mode::Unknown) {
+		initialize();
+	}
+	auto handle = GetStdHandle(STD_OUTPUT_HANDLE);
+	DWORD bytesWritten = 0;
+	if (mode == Mode::Console) {
 		if (WriteConsole(handle, v, vlen, &bytesWritten, nullptr) == FALSE) {
 			Assert(0);
 		}
+	} else if (WriteFile(handle, v, vlen, &bytesWritten, nullptr) == FALSE) {
+		Assert(0);
 	}
-	void setTextFormat(TextFormat format) override {
-		// Syntax: '0x1b[' value 'm'
-	#define ESC "\033["
-	#define ESC_LEN cstrlen(ESC)
-		static CHAR buf[0x10]{};
-		MemCopy(buf, ESC, ESC_LEN);
-		_itoa_s((INT)format, (CHAR*)buf + ESC_LEN, fmtbufcap, 10);
-		auto length = cstrlen(buf);
-		buf[length++] = 'm';
-		buf[length] = '\0';
-		write(buf, length);
+}
+
+void FileFormatSink::doWrite(const CHAR *v, INT vlen) {
+	DWORD bytesWritten = 0;
+	if (WriteFile(handle, v, vlen, &bytesWritten, nullptr) == FALSE) {
+		OsError("WriteFile", nullptr);
 	}
+}
+
+void MemoryFormatSink::doWrite(const CHAR *v, INT vlen) {
+	text.append(v, vlen);
+}
+
+//----------------------------------------------------------
+/*  One per thread, held by the {BufferedFormatStream} the thread locked first. Another stream printed
+*   to while it is held (e.g. a trace from inside a dump) writes straight through to its own sink.
+*/
+struct FormatBuffer {
+	BufferedFormatStream *stream;
+	INT                   locks;
+	INT                   length;
+	CHAR                  text[0x2000];
 };
+static thread_local FormatBuffer formatBuffer{};
 
-SRWLOCK ConsoleFormatStream::srw{};
-thread_local INT ConsoleFormatStream::locks{};
-bool ConsoleFormatStream::initialized{};
+void BufferedFormatStream::lock() {
+	auto &buffer = formatBuffer;
+	Assert(buffer.locks >= 0);
+	if (buffer.locks == 0) {
+		buffer.stream = this;
+	}
+	if (buffer.stream == this) {
+		++buffer.locks;
+	}
+}
 
-static ConsoleFormatStream consoleFormatStream{};
+void BufferedFormatStream::unlock() {
+	auto &buffer = formatBuffer;
+	if (buffer.stream != this) {
+		return;
+	}
+	Assert(buffer.locks > 0);
+	if (--buffer.locks == 0) {
+		flush();
+	}
+}
+
+void BufferedFormatStream::flush() {
+	auto &buffer = formatBuffer;
+	if (buffer.stream == this && buffer.length > 0) {
+		sink->write(buffer.text, buffer.length);
+		buffer.length = 0;
+	}
+}
+
+void BufferedFormatStream::doWrite(const CHAR *v, INT vlen) {
+	Assert(vlen >= 0);
+	if (v == nullptr || vlen == 0) {
+		return;
+	}
+	auto &buffer = formatBuffer;
+	if (buffer.stream != this || buffer.locks == 0) {
+		sink->write(v, vlen);
+		return;
+	}
+	const auto capacity = (INT)_countof(buffer.text);
+	if (buffer.length + vlen > capacity) {
+		flush();
+		if (vlen > capacity) {
+			sink->write(v, vlen);
+			return;
+		}
+	}
+	MemCopy(buffer.text + buffer.length, v, vlen);
+	buffer.length += vlen;
+}
+
+void BufferedFormatStream::setTextFormat(TextFormat format) {
+	if (!sink->isaTerminal()) {
+		return;
+	}
+	// Syntax: '0x1b[' value 'm'
+#define ESC "\033["
+#define ESC_LEN cstrlen(ESC)
+	CHAR buf[0x10]{};
+	MemCopy(buf, ESC, ESC_LEN);
+	_itoa_s((INT)format, (CHAR*)buf + ESC_LEN, _countof(buf) - ESC_LEN, 10);
+	auto length = cstrlen(buf);
+	buf[length++] = 'm';
+	buf[length] = '\0';
+	write(buf, length);
+}
+
+static ConsoleFormatSink    consoleFormatSink{};
+static BufferedFormatStream consoleFormatStream{ &consoleFormatSink };
 
 FormatStream* getConsoleFormatStream() {
 	return &consoleFormatStream;
 }
 
+bool isConsoleaTerminal() {
+	return consoleFormatStream.sink->isaTerminal();
+}
+
+FormatSink* redirectConsoleFormatStream(FormatSink *sink) {
+	auto previous = consoleFormatStream.sink;
+	consoleFormatStream.sink = sink != nullptr ? sink : &consoleFormatSink;
+	return previous;
+}
+
 
 using TxtFmt = FormatStream::TextFormat;
 
@@ -162,22 +259,52 @@ struct Colorizer {
 	}
 };
 
-struct Formatter {
-	FormatStream &stream;
-	const CHAR   *mark;
-	const CHAR   *pos;
-	va_list       vargs;
+enum class FormatOpKind {
+	Text,       // {FormatOp::text}
+	Depth,      // '%depth'
+	Cstr,       // '%c'
+	Str,        // '%s'
+	SyntaxKind, // '%sk'
+	Int,        // '%i' | '%i8' | '%i16' | '%i32' | '%i64'
+	UInt,       // '%u' | '%u8' | '%u16' | '%u32' | '%u64'
+	Keyword,    // '%kw'
+	TpKind,     // '%tpk'
+	TpType,     // '%tptype'
+	Token,      // '%tok'
+	TokenKind,  // '%tk'
+};
 
-	Formatter(FormatStream &stream, const CHAR *fmt, va_list vargs) : stream(stream), mark(fmt),
-		pos(fmt), vargs(vargs) {}
+struct FormatOp {
+	FormatOpKind kind;
+	Specifiers   specs;
+	const CHAR  *text;   // Text only: points into the format string.
+	INT          length; // Text: the length of {text}. Int | UInt: the size of the argument.
+};
 
-	void take() {
-		auto length = (INT)(pos - mark);
+/*  Parses a format string once into the {FormatOp}s that {Formatter} runs: the literal runs, the kind
+*   of each argument and its specifiers with their {TextFormat}s resolved.
+*/
+struct FormatCompiler {
+	List<FormatOp> &ops;
+	const CHAR     *mark;
+	const CHAR     *pos;
+
+	FormatCompiler(List<FormatOp> &ops, const CHAR *fmt) : ops(ops), mark(fmt), pos(fmt) {}
+
+	void text(const CHAR *v, INT length) {
 		if (length > 0) {
-			stream.write(mark, length);
-		} else {
-			Assert(length == 0);
+			ops.append(FormatOp{ FormatOpKind::Text, {}, v, length });
 		}
+	}
+
+	void arg(FormatOpKind kind, INT size = 0) {
+		ops.append(FormatOp{ kind, parseSpecifiers(), nullptr, size });
+	}
+
+	void take() {
+		auto length = (INT)(pos - mark);
+		Assert(length >= 0);
+		text(mark, length);
 		mark = pos;
 	}
 
@@ -186,7 +313,7 @@ struct Formatter {
 			for (; *pos != '\0' && *pos != '%'; ++pos) {
 				if (*pos == '\t') {
 					take();
-					stream.write("    ");
+					text(S("    "));
 					++mark; // {mark} will now start after '\t'.
 				}
 			}
@@ -199,204 +326,86 @@ struct Formatter {
 		take();
 	}
 
+	bool skip(const CHAR *v) {
+		auto length = cstrlen(v);
+		for (auto i = 0; i < length; i++) {
+			if (pos[i] != v[i]) {
+				return false;
+			}
+		}
+		pos += length;
+		return true;
+	}
+
 	void parse() {
 		// {mark} is at '%'.
 		// {pos} is just past '%'.
 		switch (auto ch = *pos++) { // {ch} is character after '%'. {pos} is now past that character.
 			case '%': { // '%%'
-				stream.write(S("%"));
-				++pos; // {pos} is now past the second '%'.
+				text(S("%"));
 			} break;
 			case 'c': {
-				auto specs = parseSpecifiers();
-				auto   arg = __crt_va_arg(vargs, CHAR*);
-				if (arg != nullptr) {
-					auto   len = cstrlen(arg);
-					fmtCstr(specs, arg, len);
-				}
+				arg(FormatOpKind::Cstr);
 			} break;
 			case 's': {
-				if (*pos == 'k') {
-					++pos;
-					auto specs = parseSpecifiers();
-					auto   arg = __crt_va_arg(vargs, SyntaxKind);
-					fmtSyntaxKind(specs, arg);
-					break;
+				if (skip("k")) {
+					arg(FormatOpKind::SyntaxKind);
+				} else {
+					arg(FormatOpKind::Str);
 				}
-				auto specs = parseSpecifiers();
-				auto   arg = __crt_va_arg(vargs, String*);
-				fmtStr(specs, arg);
 			} break;
 			case 'd': {
-				if (*pos == 'e') {
-					++pos; // Past 'e'.
-					if (*pos == 'p') {
-						++pos; // Past 'p'.
-						if (*pos == 't') {
-							++pos; // Past 't'.
-							if (*pos == 'h') {
-								++pos; // Past 'h'.
-								auto specs = parseSpecifiers();
-								if (typer != nullptr) {
-									auto depth = typer->current->depth;
-									for (auto i = 0; i < depth; i++) {
-										writeBuf(specs, S("  "));
-									}
-								}
-								break;
-							}
-							--pos; // Back to 'h'.
-						}
-						--pos; // Back to 't'.
-					}
-					--pos; // Back to 'e'.
+				if (skip("epth")) {
+					arg(FormatOpKind::Depth);
+					break;
 				}
-				--pos; // Back to 'd'.
 				Assert(0);
 			} break;
 			case 'i': { // '%i'
-				if (*pos == '6') {
-					++pos; // Past '6'.
-					if (*pos == '4') {
-						++pos; // Past '4'
-						auto specs = parseSpecifiers();
-						auto   arg = __crt_va_arg(vargs, INT64);
-						fmtInt(specs, arg, sizeof(INT64));
-						break;
-					}
-					--pos; // Back to '6'.
-				} else if (*pos == '3') {
-					++pos; // Past '3'.
-					if (*pos == '2') {
-						++pos; // Past '2'
-						auto specs = parseSpecifiers();
-						auto   arg = __crt_va_arg(vargs, INT);
-						fmtInt(specs, arg, sizeof(INT32));
-						break;
-					}
-					--pos; // Back to '3'.
-				} else if (*pos == '1') {
-					++pos; // Past '1'.
-					if (*pos == '6') {
-						++pos; // Past '6'
-						auto specs = parseSpecifiers();
-						auto   arg = __crt_va_arg(vargs, INT);
-						fmtInt(specs, arg, sizeof(INT16));
-						break;
-					}
-					--pos; // Back to '1'.
-				} else if (*pos == '8') {
-					auto specs = parseSpecifiers();
-					auto   arg = __crt_va_arg(vargs, INT);
-					fmtInt(specs, arg, sizeof(INT8));
-					break;
+				if (skip("64")) {
+					arg(FormatOpKind::Int, sizeof(INT64));
+				} else if (skip("32")) {
+					arg(FormatOpKind::Int, sizeof(INT32));
+				} else if (skip("16")) {
+					arg(FormatOpKind::Int, sizeof(INT16));
+				} else if (skip("8")) {
+					arg(FormatOpKind::Int, sizeof(INT8));
+				} else {
+					arg(FormatOpKind::Int, sizeof(INT));
 				}
-				auto specs = parseSpecifiers();
-				auto   arg = __crt_va_arg(vargs, INT);
-				fmtInt(specs, arg, sizeof(INT));
 			} break;
 			case 'u': { // '%u'
-				if (*pos == '6') {
-					++pos; // Past '6'.
-					if (*pos == '4') {
-						++pos; // Past '4'
-						auto specs = parseSpecifiers();
-						auto   arg = __crt_va_arg(vargs, UINT64);
-						fmtUInt(specs, arg, sizeof(UINT64));
-						break;
-					}
-					--pos; // Back to '6'.
-				} else if (*pos == '3') {
-					++pos; // Past '3'.
-					if (*pos == '2') {
-						++pos; // Past '2'
-						auto specs = parseSpecifiers();
-						auto   arg = __crt_va_arg(vargs, UINT);
-						fmtUInt(specs, arg, sizeof(UINT32));
-						break;
-					}
-					--pos; // Back to '3'.
-				} else if (*pos == '1') {
-					++pos; // Past '1'.
-					if (*pos == '6') {
-						++pos; // Past '6'
-						auto specs = parseSpecifiers();
-						auto   arg = __crt_va_arg(vargs, UINT);
-						fmtUInt(specs, arg, sizeof(UINT16));
-						break;
-					}
-					--pos; // Back to '1'.
-				} else if (*pos == '8') {
-					auto specs = parseSpecifiers();
-					auto   arg = __crt_va_arg(vargs, UINT);
-					fmtUInt(specs, arg, sizeof(UINT8));
-					break;
+				if (skip("64")) {
+					arg(FormatOpKind::UInt, sizeof(UINT64));
+				} else if (skip("32")) {
+					arg(FormatOpKind::UInt, sizeof(UINT32));
+				} else if (skip("16")) {
+					arg(FormatOpKind::UInt, sizeof(UINT16));
+				} else if (skip("8")) {
+					arg(FormatOpKind::UInt, sizeof(UINT8));
+				} else {
+					arg(FormatOpKind::UInt, sizeof(UINT));
 				}
-				auto specs = parseSpecifiers();
-				auto   arg = __crt_va_arg(vargs, UINT);
-				fmtUInt(specs, arg, sizeof(UINT));
 			} break;
 			case 'k': {
-				if (*pos == 'w') {
-					++pos; // Past 'w'.
-					auto specs = parseSpecifiers();
-					auto   arg = __crt_va_arg(vargs, Keyword);
-					fmtKeyword(specs, arg);
+				if (skip("w")) {
+					arg(FormatOpKind::Keyword);
 					break;
 				}
 				Assert(0);
 			} break;
 			case 't': {
-				if (*pos == 'p') {
-					++pos; // Past 'p'.
-					if (*pos == 'k') {
-						++pos; // Past 'k'.
-						auto specs = parseSpecifiers();
-						auto   arg = __crt_va_arg(vargs, TpKind);
-						fmtTpKind(specs, arg);
-						break;
-					} else if (*pos == 't') {
-						++pos; // Past 't'.
-						if (*pos == 'y') {
-							++pos; // Past 'y'.
-							if (*pos == 'p') {
-								++pos; // Past 'p'.
-								if (*pos == 'e') {
-									++pos; // Past 'e'.
-									auto specs = parseSpecifiers();
-									auto   arg = __crt_va_arg(vargs, TpType*);
-									if (arg == nullptr) {
-										fmtCstr(specs, S("<NullReference>"));
-									} else {
-										fmtTpType(specs, *arg);
-									}
-									break;
-								}
-								--pos; // Back to 'e'.
-							}
-							--pos; // Back to 'y'.
-						}
-						--pos; // Back to 't'.
-					}
-					--pos; // Back to 'p'.
-				} else if (*pos == 'o') {
-					++pos; // Past 'o'.
-					if (*pos == 'k') {
-						++pos; // Past 'k'
-						auto specs = parseSpecifiers();
-						auto   arg = __crt_va_arg(vargs, SourceToken*);
-						fmtToken(specs, arg);
-						break;
-					}
-					--pos; // Back to 'o'.
-				} else if (*pos == 'k') {
-					++pos; // Past 'k'.
-					auto specs = parseSpecifiers();
-					auto   arg = __crt_va_arg(vargs, Tok);
-					fmtTokenKind(specs, arg);
-					break;
+				if (skip("pk")) {
+					arg(FormatOpKind::TpKind);
+				} else if (skip("ptype")) {
+					arg(FormatOpKind::TpType);
+				} else if (skip("ok")) {
+					arg(FormatOpKind::Token);
+				} else if (skip("k")) {
+					arg(FormatOpKind::TokenKind);
+				} else {
+					Assert(0);
 				}
-				Assert(0);
 			} break;
 			default:
 				Assert(0);
@@ -405,6 +414,285 @@ struct Formatter {
 		mark = pos;
 	}
 
+	Specifiers parseSpecifiers() {
+		Specifiers specs{};
+		auto hash = pos;
+		while (*pos == '#') {
+			hash = pos++; // {hash} is at '#'. {pos} is just past the '#'.
+			if (*pos == '\0') {
+				break;
+			}
+			parseSpecifier(specs);
+			hash = pos; // Now {hash} is just past the spec.
+		}
+		pos = hash;
+		return specs;
+	}
+
+	void parseSpecifier(Specifiers &specs) {
+		switch (*pos++) {
+			case '<':
+				parseTextFormat(specs);
+				break;
+			case '0': {
+				specs.isZeroPrefixed = true;
+				switch (*pos++) {
+					case 'X': {
+						specs.numFmt = NumFmt::Hexadecimal;
+						specs.isUpperCase = true;
+					} break;
+					case 'x': {
+						specs.numFmt = NumFmt::Hexadecimal;
+					} break;
+					case 'B':
+					case 'b': {
+						specs.numFmt = NumFmt::Binary;
+					} break;
+					case 'O':
+					case 'o': {
+						specs.numFmt = NumFmt::Octal;
+					} break;
+					default:
+						Assert(0);
+						break;
+				}
+			} break;
+			case 'X': {
+				specs.numFmt = NumFmt::Hexadecimal;
+				specs.isUpperCase = true;
+			} break;
+			case 'x': {
+				specs.numFmt = NumFmt::Hexadecimal;
+			} break;
+			case 'B':
+			case 'b': {
+				specs.numFmt = NumFmt::Binary;
+			} break;
+			case 'O':
+			case 'o': {
+				specs.numFmt = NumFmt::Octal;
+			} break;
+			default:
+				Assert(0);
+				break;
+		}
+	}
+
+	/*  Syntax        := '<' [ Content ] '>'
+	*   Content       := SP* Token [ Content ]
+	*   Token         := '|' | Color
+	*   Color         := see TextFormat
+	*   ForeColor     := Color
+	*   BackColor     := '|' Color
+	*/
+	void parseTextFormat(Specifiers &specs) {
+		while (*pos != '\0' && *pos != '>') {
+			auto fmt = nextTextFormat();
+			if (fmt == TxtFmt::Unknown) {
+				continue;
+			} if (fmt >= TxtFmt::BackDarkBlack && fmt <= TxtFmt::BackDarkWhite) {
+				specs.back = fmt;
+			} else if (fmt >= TxtFmt::BackBlack && fmt <= TxtFmt::BackWhite) {
+				specs.back = fmt;
+			} else if (fmt == TxtFmt::Underline) {
+				specs.isUnderlined = true;
+			} else if (fmt == TxtFmt::Bright) {
+				specs.isBold = true;
+			} else {
+				specs.fore = fmt;
+			}
+		}
+		Assert(*pos == '>');
+		++pos; // Leave {pos} just past the closing '>'.
+	}
+
+	TxtFmt nextTextFormat(bool back = false) {
+		while (*pos == ' ') ++pos; // Skip spaces.
+		if (*pos == '|') {
+			++pos;
+			return nextTextFormat(true);
+		} if (*pos == '>') {
+			return TxtFmt::Unknown;
+		}
+		auto start = pos++;
+		for (; *pos && *pos != ' ' && *pos != '|' && *pos != '>'; ++pos) {}
+		String token{ start, pos };
+		if (back) {
+			return parseBackTextFormat(token);
+		}
+		return parseForeTextFormat(token);
+	}
+
+	TxtFmt parseForeTextFormat(const String &token) {
+		static struct {
+			String name;
+			TxtFmt value;
+		} list[] = {
+			{ { "default" }, TxtFmt::Default },
+			{ { "bold" }, TxtFmt::Bright },
+			{ { "underline" }, TxtFmt::Underline },
+			{ { "darkblack" }, TxtFmt::ForeDarkBlack },
+			{ { "darkred" }, TxtFmt::ForeDarkRed },
+			{ { "darkgreen" }, TxtFmt::ForeDarkGreen },
+			{ { "darkyellow" }, TxtFmt::ForeDarkYellow },
+			{ { "darkblue" }, TxtFmt::ForeDarkBlue },
+			{ { "darkmagenta" }, TxtFmt::ForeDarkMagenta },
+			{ { "darkcyan" }, TxtFmt::ForeDarkCyan },
+			{ { "darkwhite" }, TxtFmt::ForeDarkWhite },
+			{ { "gray" }, TxtFmt::ForeDarkWhite },
+			{ { "grey" }, TxtFmt::ForeDarkWhite },
+			{ { "black" }, TxtFmt::ForeBlack },
+			{ { "red" }, TxtFmt::ForeRed },
+			{ { "green" }, TxtFmt::ForeGreen },
+			{ { "yellow" }, TxtFmt::ForeYellow },
+			{ { "blue" }, TxtFmt::ForeBlue },
+			{ { "magenta" }, TxtFmt::ForeMagenta },
+			{ { "cyan" }, TxtFmt::ForeCyan },
+			{ { "white" }, TxtFmt::ForeWhite }
+		};
+		for (auto i = 0; i < (INT)_countof(list); ++i) {
+			auto item = list[i];
+			if (token == item.name) {
+				return item.value;
+			}
+		}
+		return TxtFmt::Unknown;
+	}
+
+	TxtFmt parseBackTextFormat(const String &token) {
+		static struct {
+			String name;
+			TxtFmt value;
+		} list[] = {
+			{ { "default" }, TxtFmt::Default },
+			{ { "bold" }, TxtFmt::Bright },
+			{ { "underline" }, TxtFmt::Underline },
+			{ { "darkblack" }, TxtFmt::BackDarkBlack },
+			{ { "darkred" }, TxtFmt::BackDarkRed },
+			{ { "darkgreen" }, TxtFmt::BackDarkGreen },
+			{ { "darkyellow" }, TxtFmt::BackDarkYellow },
+			{ { "darkblue" }, TxtFmt::BackDarkBlue },
+			{ { "darkmagenta" }, TxtFmt::BackDarkMagenta },
+			{ { "darkcyan" }, TxtFmt::BackDarkCyan },
+			{ { "darkwhite" }, TxtFmt::BackDarkWhite },
+			{ { "gray" }, TxtFmt::BackDarkWhite },
+			{ { "grey" }, TxtFmt::BackDarkWhite },
+			{ { "black" }, TxtFmt::BackBlack },
+			{ { "red" }, TxtFmt::BackRed },
+			{ { "green" }, TxtFmt::BackGreen },
+			{ { "yellow" }, TxtFmt::BackYellow },
+			{ { "blue" }, TxtFmt::BackBlue },
+			{ { "magenta" }, TxtFmt::BackMagenta },
+			{ { "cyan" }, TxtFmt::BackCyan },
+			{ { "white" }, TxtFmt::BackWhite }
+		};
+		for (auto i = 0; i < (INT)_countof(list); ++i) {
+			auto item = list[i];
+			if (token == item.name) {
+				return item.value;
+			}
+		}
+		return TxtFmt::Unknown;
+	}
+};
+
+/*  The compiled form of each format string this thread has printed, by its address: {print} requires
+*   format strings with static storage, so each is parsed once however often it is printed.
+*/
+static thread_local Dict<List<FormatOp>, UINT64> formats{};
+
+static List<FormatOp> compileFormat(const CHAR *fmt) {
+	auto hash = UINT64(fmt);
+	auto  idx = formats.indexOf(hash);
+	if (idx >= 0) {
+		return formats.items[idx].value;
+	}
+	List<FormatOp> ops{};
+	FormatCompiler compiler{ ops, fmt };
+	compiler.run();
+	ops.compact();
+	return formats.append(hash, ops);
+}
+
+void disposeFormats() {
+	formats.dispose([](List<FormatOp> &ops) { ops.dispose(); });
+}
+
+struct Formatter {
+	FormatStream &stream;
+	va_list       vargs;
+
+	Formatter(FormatStream &stream, va_list vargs) : stream(stream), vargs(vargs) {}
+
+	void run(const CHAR *fmt) {
+		auto ops = compileFormat(fmt);
+		for (auto i = 0; i < ops.length; i++) {
+			auto &op = ops.items[i];
+			auto specs = op.specs; // The fmt* below may recolor parts of their argument.
+			switch (op.kind) {
+				case FormatOpKind::Text: {
+					stream.write(op.text, op.length);
+				} break;
+				case FormatOpKind::Depth: {
+					if (typer != nullptr) {
+						auto depth = typer->current->depth;
+						for (auto j = 0; j < depth; j++) {
+							writeBuf(specs, S("  "));
+						}
+					}
+				} break;
+				case FormatOpKind::Cstr: {
+					auto arg = __crt_va_arg(vargs, CHAR*);
+					if (arg != nullptr) {
+						fmtCstr(specs, arg, cstrlen(arg));
+					}
+				} break;
+				case FormatOpKind::Str: {
+					fmtStr(specs, __crt_va_arg(vargs, String*));
+				} break;
+				case FormatOpKind::SyntaxKind: {
+					fmtSyntaxKind(specs, __crt_va_arg(vargs, SyntaxKind));
+				} break;
+				case FormatOpKind::Int: {
+					if (op.length == sizeof(INT64)) {
+						fmtInt(specs, __crt_va_arg(vargs, INT64), op.length);
+					} else {
+						fmtInt(specs, __crt_va_arg(vargs, INT), op.length);
+					}
+				} break;
+				case FormatOpKind::UInt: {
+					if (op.length == sizeof(UINT64)) {
+						fmtUInt(specs, __crt_va_arg(vargs, UINT64), op.length);
+					} else {
+						fmtUInt(specs, __crt_va_arg(vargs, UINT), op.length);
+					}
+				} break;
+				case FormatOpKind::Keyword: {
+					fmtKeyword(specs, __crt_va_arg(vargs, Keyword));
+				} break;
+				case FormatOpKind::TpKind: {
+					fmtTpKind(specs, __crt_va_arg(vargs, TpKind));
+				} break;
+				case FormatOpKind::TpType: {
+					auto arg = __crt_va_arg(vargs, TpType*);
+					if (arg == nullptr) {
+						fmtCstr(specs, S("<NullReference>"));
+					} else {
+						fmtTpType(specs, *arg);
+					}
+				} break;
+				case FormatOpKind::Token: {
+					fmtToken(specs, __crt_va_arg(vargs, SourceToken*));
+				} break;
+				case FormatOpKind::TokenKind: {
+					fmtTokenKind(specs, __crt_va_arg(vargs, Tok));
+				} break;
+				default:
+					UNREACHABLE();
+			}
+		}
+	}
+
 	void fmtCstr(Specifiers &specs, const CHAR *arg, INT len) {
 		writeBuf(specs, arg, len);
 	}
@@ -735,188 +1023,77 @@ struct Formatter {
 		stream.write(buf, len);
 		stream.unlock();
 	}
+};
 
-	Specifiers parseSpecifiers() {
-		Specifiers specs{};
-		auto hash = pos;
-		while (*pos == '#') {
-			hash = pos++; // {hash} is at '#'. {pos} is just past the '#'.
-			if (*pos == '\0') {
-				break;
-			}
-			parseSpecifier(specs);
-			hash = pos; // Now {hash} is just past the spec.
+//----------------------------------------------------------
+static bool parseTraceLevel(const String &name, TraceLevel &level) {
+	static struct {
+		String     name;
+		TraceLevel value;
+	} list[] = {
+		{ { "off" }, TraceLevel::Off },
+		{ { "error" }, TraceLevel::Error },
+		{ { "warn" }, TraceLevel::Warn },
+		{ { "info" }, TraceLevel::Info },
+		{ { "debug" }, TraceLevel::Debug },
+		{ { "trace" }, TraceLevel::Trace }
+	};
+	for (auto i = 0; i < (INT)_countof(list); ++i) {
+		if (name == list[i].name) {
+			level = list[i].value;
+			return true;
 		}
-		pos = hash;
-		return specs;
 	}
+	return false;
+}
 
-	void parseSpecifier(Specifiers &specs) {
-		switch (*pos++) {
-			case '<':
-				parseTextFormat(specs);
-				break;
-			case '0': {
-				specs.isZeroPrefixed = true;
-				switch (*pos++) {
-					case 'X': {
-						specs.numFmt = NumFmt::Hexadecimal;
-						specs.isUpperCase = true;
-					} break;
-					case 'x': {
-						specs.numFmt = NumFmt::Hexadecimal;
-					} break;
-					case 'B':
-					case 'b': {
-						specs.numFmt = NumFmt::Binary;
-					} break;
-					case 'O':
-					case 'o': {
-						specs.numFmt = NumFmt::Octal;
-					} break;
-					default:
-						Assert(0);
-						break;
-				}
-			} break;
-			case 'X': {
-				specs.numFmt = NumFmt::Hexadecimal;
-				specs.isUpperCase = true;
-			} break;
-			case 'x': {
-				specs.numFmt = NumFmt::Hexadecimal;
-			} break;
-			case 'B':
-			case 'b': {
-				specs.numFmt = NumFmt::Binary;
-			} break;
-			case 'O':
-			case 'o': {
-				specs.numFmt = NumFmt::Octal;
-			} break;
-			default:
-				Assert(0);
-				break;
+static INT parseTraceCategory(const String &name) {
+	static const String list[] = {
+	#define ZM(zName) { #zName },
+		DeclareTraceCategories(ZM)
+	#undef ZM
+	};
+	for (auto i = 0; i < (INT)_countof(list); ++i) {
+		if (name.length == list[i].length && _strnicmp(name.text, list[i].text, name.length) == 0) {
+			return i;
 		}
 	}
+	return -1;
+}
 
-	/*  Syntax        := '<' [ Content ] '>'
-	*   Content       := SP* Token [ Content ]
-	*   Token         := '|' | Color
-	*   Color         := see TextFormat
-	*   ForeColor     := Color
-	*   BackColor     := '|' Color
-	*/
-	void parseTextFormat(Specifiers &specs) {
-		while (*pos != '\0' && *pos != '>') {
-			auto fmt = nextTextFormat();
-			if (fmt == TxtFmt::Unknown) {
-				continue;
-			} if (fmt >= TxtFmt::BackDarkBlack && fmt <= TxtFmt::BackDarkWhite) {
-				specs.back = fmt;
-			} else if (fmt >= TxtFmt::BackBlack && fmt <= TxtFmt::BackWhite) {
-				specs.back = fmt;
-			} else if (fmt == TxtFmt::Underline) {
-				specs.isUnderlined = true;
-			} else if (fmt == TxtFmt::Bright) {
-				specs.isBold = true;
-			} else {
-				specs.fore = fmt;
-			}
+bool setTraceLevels(const CHAR *spec) {
+	auto level = TraceLevel::Info;
+	String all{ spec };
+	if (parseTraceLevel(all, level)) {
+		for (auto i = 0; i < (INT)_countof(traceLevels); ++i) {
+			traceLevels[i] = level;
 		}
-		Assert(*pos == '>');
-		++pos; // Leave {pos} just past the closing '>'.
+		return true;
 	}
-
-	TxtFmt nextTextFormat(bool back = false) {
-		while (*pos == ' ') ++pos; // Skip spaces.
-		if (*pos == '|') {
-			++pos;
-			return nextTextFormat(true);
-		} if (*pos == '>') {
-			return TxtFmt::Unknown;
+	TraceLevel levels[_countof(traceLevels)]{};
+	MemCopy(levels, traceLevels, _countof(levels));
+	for (auto pos = spec; *pos != '\0';) {
+		auto start = pos;
+		for (; *pos != '\0' && *pos != '='; ++pos) {}
+		if (*pos != '=') {
+			return false;
 		}
-		auto start = pos++;
-		for (; *pos && *pos != ' ' && *pos != '|' && *pos != '>'; ++pos) {}
-		String token{ start, pos };
-		if (back) {
-			return parseBackTextFormat(token);
-		}
-		return parseForeTextFormat(token);
-	}
-
-	TxtFmt parseForeTextFormat(const String &token) {
-		static struct {
-			String name;
-			TxtFmt value;
-		} list[] = {
-			{ { "default" }, TxtFmt::Default },
-			{ { "bold" }, TxtFmt::Bright },
-			{ { "underline" }, TxtFmt::Underline },
-			{ { "darkblack" }, TxtFmt::ForeDarkBlack },
-			{ { "darkred" }, TxtFmt::ForeDarkRed },
-			{ { "darkgreen" }, TxtFmt::ForeDarkGreen },
-			{ { "darkyellow" }, TxtFmt::ForeDarkYellow },
-			{ { "darkblue" }, TxtFmt::ForeDarkBlue },
-			{ { "darkmagenta" }, TxtFmt::ForeDarkMagenta },
-			{ { "darkcyan" }, TxtFmt::ForeDarkCyan },
-			{ { "darkwhite" }, TxtFmt::ForeDarkWhite },
-			{ { "gray" }, TxtFmt::ForeDarkWhite },
-			{ { "grey" }, TxtFmt::ForeDarkWhite },
-			{ { "black" }, TxtFmt::ForeBlack },
-			{ { "red" }, TxtFmt::ForeRed },
-			{ { "green" }, TxtFmt::ForeGreen },
-			{ { "yellow" }, TxtFmt::ForeYellow },
-			{ { "blue" }, TxtFmt::ForeBlue },
-			{ { "magenta" }, TxtFmt::ForeMagenta },
-			{ { "cyan" }, TxtFmt::ForeCyan },
-			{ { "white" }, TxtFmt::ForeWhite }
-		};
-		for (auto i = 0; i < (INT)_countof(list); ++i) {
-			auto item = list[i];
-			if (token == item.name) {
-				return item.value;
-			}
+		String categoryName{ start, pos++ };
+		start = pos;
+		for (; *pos != '\0' && *pos != ','; ++pos) {}
+		String levelName{ start, pos };
+		if (*pos == ',') {
+			++pos;
 		}
-		return TxtFmt::Unknown;
-	}
-
-	TxtFmt parseBackTextFormat(const String &token) {
-		static struct {
-			String name;
-			TxtFmt value;
-		} list[] = {
-			{ { "default" }, TxtFmt::Default },
-			{ { "bold" }, TxtFmt::Bright },
-			{ { "underline" }, TxtFmt::Underline },
-			{ { "darkblack" }, TxtFmt::BackDarkBlack },
-			{ { "darkred" }, TxtFmt::BackDarkRed },
-			{ { "darkgreen" }, TxtFmt::BackDarkGreen },
-			{ { "darkyellow" }, TxtFmt::BackDarkYellow },
-			{ { "darkblue" }, TxtFmt::BackDarkBlue },
-			{ { "darkmagenta" }, TxtFmt::BackDarkMagenta },
-			{ { "darkcyan" }, TxtFmt::BackDarkCyan },
-			{ { "darkwhite" }, TxtFmt::BackDarkWhite },
-			{ { "gray" }, TxtFmt::BackDarkWhite },
-			{ { "grey" }, TxtFmt::BackDarkWhite },
-			{ { "black" }, TxtFmt::BackBlack },
-			{ { "red" }, TxtFmt::BackRed },
-			{ { "green" }, TxtFmt::BackGreen },
-			{ { "yellow" }, TxtFmt::BackYellow },
-			{ { "blue" }, TxtFmt::BackBlue },
-			{ { "magenta" }, TxtFmt::BackMagenta },
-			{ { "cyan" }, TxtFmt::BackCyan },
-			{ { "white" }, TxtFmt::BackWhite }
-		};
-		for (auto i = 0; i < (INT)_countof(list); ++i) {
-			auto item = list[i];
-			if (token == item.name) {
-				return item.value;
-			}
+		auto category = parseTraceCategory(categoryName);
+		if (category < 0 || !parseTraceLevel(levelName, level)) {
+			return false;
 		}
-		return TxtFmt::Unknown;
+		levels[category] = level;
 	}
-};
+	MemCopy(traceLevels, levels, _countof(levels));
+	return true;
+}
 
 void print(FormatStream *stream, const CHAR *fmt, ...) {
 	va_list vargs{};
@@ -929,8 +1106,8 @@ void vprint(FormatStream *stream, const CHAR *fmt, va_list vargs) {
 	if (fmt) {
 		if (stream != nullptr) {
 			stream->lock();
-			Formatter formatter{ *stream, fmt, vargs };
-			formatter.run();
+			Formatter formatter{ *stream, vargs };
+			formatter.run(fmt);
 			stream->unlock();
 		} else {
 			auto strm = getConsoleFormatStream();
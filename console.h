@@ -56,14 +56,117 @@ protected:
     virtual void doWrite(const CHAR*, INT) = 0;
 };
 
+/* Where a {BufferedFormatStream} sends its text, one whole line (or full buffer) per {write}. */
+struct FormatSink {
+    void write(const CHAR*, INT);
+    virtual bool isaTerminal() const { return false; } // Whether {FormatStream::TextFormat}s are written.
+protected:
+    SRWLOCK srw{};
+    virtual void doWrite(const CHAR*, INT) = 0;
+};
+
+struct ConsoleFormatSink : FormatSink {
+    bool isaTerminal() const override;
+protected:
+    void doWrite(const CHAR*, INT) override;
+private:
+    enum class Mode { Unknown, Console, Redirected };
+    Mode mode = Mode::Unknown;
+    void initialize();
+};
+
+struct FileFormatSink : FormatSink {
+    HANDLE handle;
+    FileFormatSink(HANDLE handle) : handle(handle) {}
+protected:
+    void doWrite(const CHAR*, INT) override;
+};
+
+struct MemoryFormatSink : FormatSink {
+    String text{};
+    void dispose() { text.dispose(); }
+protected:
+    void doWrite(const CHAR*, INT) override;
+};
+
+/*  Collects what one thread prints into a thread-local buffer and hands it to {sink} when the outermost
+*   {unlock} is reached, so a {traceln} is one write however many fragments and colors it is made of.
+*/
+struct BufferedFormatStream : FormatStream {
+    FormatSink *sink;
+
+    BufferedFormatStream(FormatSink *sink) : sink(sink) {}
+    void setTextFormat(TextFormat) override;
+    void lock() override;
+    void unlock() override;
+    void flush();
+protected:
+    void doWrite(const CHAR*, INT) override;
+};
+
 FormatStream* getConsoleFormatStream();
+FormatSink* redirectConsoleFormatStream(FormatSink *sink); // Returns the previous sink.
+bool isConsoleaTerminal(); // Whether what the console stream prints shows {FormatStream::TextFormat}s.
 
+/*  {fmt} must have static storage, as a string literal has: each thread compiles a format string once and
+*   keeps the result by its address, with the text between specifiers pointing into {fmt}. A format built
+*   at run time would print whatever its address held when it was first compiled; pass such text through
+*   '%c' or '%s' instead.
+*/
 void print(FormatStream *stream, const CHAR *fmt, ...);
 void vprint(FormatStream *stream, const CHAR *fmt, va_list vargs);
 void println(FormatStream *stream, const CHAR *fmt, ...);
 void vprintln(FormatStream *stream, const CHAR *fmt, va_list vargs);
+void disposeFormats(); // Frees the format strings this thread compiled; a thread that printed calls it last.
+
+//----------------------------------------------------------
+#define DeclareTraceCategories(ZM) \
+    ZM(Tokenizer)                  \
+    ZM(Parser)                     \
+    ZM(Module)                     \
+    ZM(Typer)                      \
+    ZM(Aio)
+
+enum class TraceCategory {
+#define ZM(zName) zName,
+    DeclareTraceCategories(ZM)
+#undef ZM
+    Count
+};
+
+enum class TraceLevel {
+    Off, Error, Warn, Info, Debug, Trace
+};
+
+/*  The most verbose level compiled in: {logln}s above it compile away. Define {EXY_TRACE_LEVEL} to
+*   one of the {TraceLevel}s' values to override.
+*/
+#ifndef EXY_TRACE_LEVEL
+#ifdef _DEBUG
+#define EXY_TRACE_LEVEL 5 // Trace
+#else
+#define EXY_TRACE_LEVEL 3 // Info
+#endif
+#endif
+
+// The most verbose level printed for each {TraceCategory}, set with '--log'.
+inline TraceLevel traceLevels[INT(TraceCategory::Count)] = {
+#define ZM(zName) TraceLevel::Info,
+    DeclareTraceCategories(ZM)
+#undef ZM
+};
+
+// '--log' level | category '=' level [',' category '=' level]*; {false}, with no level changed, if {spec} is not understood.
+bool setTraceLevels(const CHAR *spec);
 
 } // namespace exy
 
 #define trace(fmt, ...)   exy::print(nullptr, (fmt), __VA_ARGS__)
-#define traceln(fmt, ...) exy::println(nullptr, (fmt), __VA_ARGS__)
\ No newline at end of file
+#define traceln(fmt, ...) exy::println(nullptr, (fmt), __VA_ARGS__)
+#define logln(zCategory, zLevel, fmt, ...) do {                                                                  \
+    if constexpr (INT(exy::TraceLevel::zLevel) <= EXY_TRACE_LEVEL) {                                          \
+        if (exy::traceLevels[INT(exy::TraceCategory::zCategory)] >= exy::TraceLevel::zLevel) {                 \
+            exy::println(nullptr, (fmt), __VA_ARGS__);                                                        \
+        }                                                                                                     \
+    }                                                                                                         \
+} while (0)
\ No newline at end of file
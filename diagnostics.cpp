@@ -0,0 +1,192 @@
+#include "pch.h"
+
+#include "src.h"
+
+namespace exy {
+namespace diagnostics {
+static HANDLE               handle = INVALID_HANDLE_VALUE;
+static FileFormatSink       sink{ INVALID_HANDLE_VALUE };
+static BufferedFormatStream stream{ &sink };
+static SRWLOCK              srw{};     // Keeps the records in the order {results} counts them.
+static INT64                results{}; // Written so far: the first SARIF result takes no separator.
+
+// Writes {v} as the inside of a JSON string. UTF-8 passes through unchanged.
+static void escape(const CHAR *v, INT vlen) {
+    static const CHAR hex[] = "0123456789abcdef";
+    const auto end = v + vlen;
+    auto       run = v;
+    for (auto p = v; p < end; p++) {
+        auto ch = UINT8(*p);
+        if (ch >= 0x20 && ch != '"' && ch != '\\') {
+            continue;
+        }
+        stream.write(run, INT(p - run));
+        CHAR esc[]{ '\\', 'u', '0', '0', hex[ch >> 4], hex[ch & 0xf] };
+        auto length = INT(_countof(esc));
+        switch (ch) {
+            case '"':  esc[1] = '"';  length = 2; break;
+            case '\\': esc[1] = '\\'; length = 2; break;
+            case '\n': esc[1] = 'n';  length = 2; break;
+            case '\r': esc[1] = 'r';  length = 2; break;
+            case '\t': esc[1] = 't';  length = 2; break;
+        }
+        stream.write(esc, length);
+        run = p + 1;
+    }
+    stream.write(run, INT(end - run));
+}
+
+static void quote(const CHAR *v, INT vlen) {
+    stream.write(S("\""));
+    escape(v, vlen);
+    stream.write(S("\""));
+}
+
+static void quote(const CHAR *v) {
+    quote(v, cstrlen(v));
+}
+
+static void quote(Identifier v) {
+    quote(v->text, v->length);
+}
+
+// {path} as a 'file:' URI: forward slashes, and anything but unreserved characters percent-encoded.
+static void uri(Identifier path) {
+    static const CHAR hex[] = "0123456789ABCDEF";
+    stream.write(S("\"file:///"));
+    for (auto i = 0; i < path->length; i++) {
+        auto ch = UINT8(path->text[i]);
+        if (ch == '\\') {
+            stream.write(S("/"));
+        } else if ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') ||
+                   ch == '-' || ch == '.' || ch == '_' || ch == '~' || ch == '/' || ch == ':') {
+            stream.write(path->text + i, 1);
+        } else {
+            CHAR esc[]{ '%', hex[ch >> 4], hex[ch & 0xf] };
+            stream.write(esc, INT(_countof(esc)));
+        }
+    }
+    stream.write(S("\""));
+}
+
+// The message, formatted as the console would print it but without colors, written as a JSON string.
+struct MessageSink : FormatSink {
+protected:
+    void doWrite(const CHAR *v, INT vlen) override { escape(v, vlen); }
+};
+
+static void message(const CHAR *msg, va_list ap) {
+    stream.write(S("\""));
+    if (msg != nullptr) {
+        // {stream} holds this thread's format buffer, so this writes straight through to {escape}.
+        MessageSink          messageSink{};
+        BufferedFormatStream messageStream{ &messageSink };
+        vprint(&messageStream, msg, ap);
+    }
+    stream.write(S("\""));
+}
+
+bool open() {
+    if (format == Format::None) {
+        return true;
+    }
+    if (path != nullptr && String{ path } == String{ S("-") }) {
+        handle = GetStdHandle(STD_ERROR_HANDLE);
+    } else if (path != nullptr) {
+        handle = CreateFile(path, GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    }
+    if (handle == INVALID_HANDLE_VALUE || handle == nullptr) {
+        traceln("cannot write diagnostics to %c#<red>: printing them instead", path);
+        handle = INVALID_HANDLE_VALUE;
+        format = Format::None;
+        return false;
+    }
+    sink.handle = handle;
+    if (format == Format::Sarif) {
+        print(&stream, "{\"version\":\"2.1.0\",\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\","
+                       "\"runs\":[{\"tool\":{\"driver\":{\"name\":\"exc\"}},"
+                       "\"columnKind\":\"unicodeCodePoints\",\"results\":[");
+    }
+    return true;
+}
+
+void close() {
+    if (format == Format::None) {
+        return;
+    }
+    if (format == Format::Sarif) {
+        print(&stream, "\r\n]}]}\r\n");
+    }
+    if (handle != GetStdHandle(STD_ERROR_HANDLE)) {
+        CloseHandle(handle);
+    }
+    handle = INVALID_HANDLE_VALUE;
+    sink.handle = INVALID_HANDLE_VALUE;
+    results = 0;
+}
+
+static void writeJson(INT number, const CHAR *pass, const SourceFile *file, const SourceChar *start,
+                      const SourceChar *end, const CHAR *cppFile, const CHAR *cppFunc, INT cppLine,
+                      const CHAR *msg, va_list ap) {
+    // {"number":1,"pass":"Syntax","file":"a.b","path":"C:\\a\\b.exy","start":{"line":1,"col":1},
+    //  "end":{"line":1,"col":4},"message":"...","cpp":{"file":"...","func":"...","line":1}}
+    print(&stream, "{\"number\":%i,\"pass\":", number);
+    quote(pass);
+    if (file != nullptr) {
+        stream.write(S(",\"file\":"));
+        quote(file->dotName);
+        stream.write(S(",\"path\":"));
+        quote(file->path);
+        print(&stream, ",\"start\":{\"line\":%i,\"col\":%i},\"end\":{\"line\":%i,\"col\":%i}",
+              start->line, start->col, end->line, end->col);
+    }
+    stream.write(S(",\"message\":"));
+    message(msg, ap);
+    stream.write(S(",\"cpp\":{\"file\":"));
+    quote(cppFile);
+    stream.write(S(",\"func\":"));
+    quote(cppFunc);
+    print(&stream, ",\"line\":%i}}\r\n", cppLine);
+}
+
+static void writeSarif(INT number, const CHAR *pass, const SourceFile *file, const SourceChar *start,
+                       const SourceChar *end, const CHAR *cppFile, const CHAR *cppFunc, INT cppLine,
+                       const CHAR *msg, va_list ap) {
+    print(&stream, "%c\r\n{\"ruleId\":", results ? "," : "");
+    quote(pass);
+    stream.write(S(",\"level\":\"error\",\"message\":{\"text\":"));
+    message(msg, ap);
+    stream.write(S("}"));
+    if (file != nullptr) {
+        // {end} is one past the range, as SARIF's exclusive end column is.
+        stream.write(S(",\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"uri\":"));
+        uri(file->path);
+        print(&stream, "},\"region\":{\"startLine\":%i,\"startColumn\":%i,\"endLine\":%i,\"endColumn\":%i}}"
+                       ",\"logicalLocations\":[{\"fullyQualifiedName\":",
+              start->line, start->col, end->line, end->col);
+        quote(file->dotName);
+        stream.write(S("}]}]"));
+    }
+    print(&stream, ",\"properties\":{\"number\":%i,\"cppFile\":", number);
+    quote(cppFile);
+    stream.write(S(",\"cppFunc\":"));
+    quote(cppFunc);
+    print(&stream, ",\"cppLine\":%i}}", cppLine);
+}
+
+void write(INT number, const CHAR *pass, const SourceFile *file, const SourceChar *start,
+           const SourceChar *end, const CHAR *cppFile, const CHAR *cppFunc, INT cppLine,
+           const CHAR *msg, va_list ap) {
+    AcquireSRWLockExclusive(&srw);
+    stream.lock();
+    if (format == Format::Sarif) {
+        writeSarif(number, pass, file, start, end, cppFile, cppFunc, cppLine, msg, ap);
+    } else {
+        writeJson(number, pass, file, start, end, cppFile, cppFunc, cppLine, msg, ap);
+    }
+    stream.unlock();
+    ++results;
+    ReleaseSRWLockExclusive(&srw);
+}
+} // namespace diagnostics
+} // namespace exy
\ No newline at end of file
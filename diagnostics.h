@@ -0,0 +1,30 @@
+#pragma once
+
+namespace exy {
+struct SourceFile;
+struct SourceChar;
+
+namespace diagnostics {
+enum class Format {
+    None,  // No '--diagnostics': errors are only printed to the console.
+    Json,  // '--diagnostics=json <path>': one JSON object per line, per error.
+    Sarif  // '--diagnostics=sarif <path>': a SARIF 2.1.0 log with one result per error.
+};
+inline Format format = Format::None;
+
+// Where {write} writes; '-' is standard error, which keeps the records apart from the progress printed
+// to standard output.
+inline const CHAR *path = nullptr;
+
+bool open();  // Creates {path} and starts the log; falls back to the console if it cannot.
+void close(); // Ends the log.
+
+/*  Writes one error as a record as soon as it is reported, instead of the console's highlighted
+*   source: no colors, no lines looked up, and a single write that records from other threads
+*   cannot interleave with. {file}, {start} and {end} are null if the error is not in a source file.
+*/
+void write(INT number, const CHAR *pass, const SourceFile *file, const SourceChar *start,
+           const SourceChar *end, const CHAR *cppFile, const CHAR *cppFunc, INT cppLine,
+           const CHAR *msg, va_list ap);
+} // namespace diagnostics
+} // namespace exy
\ No newline at end of file
@@ -63,32 +63,32 @@ struct Dict final {
     }
 
     T& first() {
-        Assert(length);
+        Check(length);
         return items[0].value;
     }
 
     const T& first() const {
-        Assert(length);
+        Check(length);
         return items[0].value;
     }
 
     T& last() {
-        Assert(length);
+        Check(length);
         return items[length - 1];
     }
 
     const T& last() const {
-        Assert(length);
+        Check(length);
         return items[length - 1].value;
     }
 
     T& operator[](INT index) {
-        Assert(index >= 0 && index < length);
+        Check(index >= 0 && index < length);
         return items[index].value;
     }
 
     const T& operator[](INT index) const {
-        Assert(index >= 0 && index < length);
+        Check(index >= 0 && index < length);
         return items[index].value;
     }
 
@@ -100,7 +100,7 @@ struct Dict final {
         Assert(hash);
         resize();
         const auto bucket = INT(hash % Hash(capacity));
-        Assert(bucket < capacity);
+        Assume(bucket < capacity);
         for (auto i = items[bucket].bucket; i >= 0; i = items[i].next) {
             if (items[i].hash == hash) {
                 Assert(0);
@@ -125,7 +125,7 @@ struct Dict final {
     // Get value by hash/name.
     T& get(Hash hash) {
         const auto idx = indexOf(hash);
-        Assert(idx >= 0);
+        Check(idx >= 0);
         return items[idx].value;
     }
     T& get(Identifier name) {
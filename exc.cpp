@@ -1,15 +1,76 @@
 #include "pch.h"
 #include "exc.h"
+#include "server.h"
+#include "bench.h"
+#include "parser.h"
+#include "tp_dump.h"
 
-int main(INT, const CHAR**) {
+static bool isOption(INT argc, const CHAR **argv, const CHAR *option) {
+    return argc > 1 && exy::String{ argv[1] } == exy::String{ option };
+}
+
+// The number after '--bench', 10 if there is none, or -1 if it is not a positive number.
+static INT benchRuns(INT argc, const CHAR **argv) {
+    if (argc < 3) {
+        return 10;
+    }
+    auto arg = argv[2];
+    auto len = cstrlen(arg);
+    if (len == 0 || len > 6) {
+        return -1;
+    }
+    for (auto i = 0; i < len; i++) {
+        if (arg[i] < '0' || arg[i] > '9') {
+            return -1;
+        }
+    }
+    auto runs = atoi(arg);
+    return runs > 0 ? runs : -1;
+}
+
+int main(INT argc, const CHAR **argv) {
+    auto result = 0;
     for (auto i = 0; i < 1; ++i) {
         traceln("The %c#<yellow underline> language compiler (%c#<bold>).", "exy", "exc");
         exy::heap::initialize();
-        if (exy::aio::open()) {
-            exy::Compiler::run();
+        exy::compiler.config.parseOptions(argc, argv);
+        exy::diagnostics::open();
+        if (isOption(argc, argv, "--client")) {
+            // exc --client [--compile | --stop] [--lazy] [--parallel] [--max-errors N]
+            result = exy::server::forward(argc - 2, argv + 2);
+        } else if (exy::aio::open()) {
+            if (isOption(argc, argv, "--server")) {
+                exy::server::run(argc, argv);
+            } else if (isOption(argc, argv, "--bench")) {
+                // exc --bench [runs]
+                auto runs = benchRuns(argc, argv);
+                if (runs < 0) {
+                    traceln("%c#<red> is not a number of runs: exc --bench [runs]", argv[2]);
+                    result = -1;
+                } else {
+                    result = exy::server::bench(runs);
+                }
+            } else if (isOption(argc, argv, "--bench-corpus")) {
+                // exc --bench-corpus [shape] [--warmups N] [--repetitions N] [--keep]
+                result = exy::bench::run(argc - 2, argv + 2);
+            } else if (isOption(argc, argv, "--bench-micro")) {
+                // exc --bench-micro [--repetitions N] [--json <path>]
+                result = exy::bench::micro(argc - 2, argv + 2);
+            } else if (isOption(argc, argv, "--check-numbers")) {
+                // exc --check-numbers
+                result = exy::checkNumbers();
+            } else if (isOption(argc, argv, "--check-parallel")) {
+                // exc --check-parallel [--lazy] [--corpus [shape] [--keep]]
+                result = exy::checkParallel(argc - 2, argv + 2);
+            } else {
+                exy::Compiler::run();
+            }
         }
         exy::aio::close();
+        exy::diagnostics::close();
+        exy::stats::dispose();
+        exy::disposeFormats();
         exy::heap::dispose();
     }
-    return 0;
+    return result;
 }
\ No newline at end of file
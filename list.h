@@ -85,12 +85,12 @@ struct List {
     }
 
     T& pop() {
-        Assert(length > 0);
+        Check(length > 0);
         return items[--length];
     }
 
     T& insert(INT at) {
-        Assert(at >= 0 && at <= length);
+        Check(at >= 0 && at <= length);
         reserve(1);
         MemMove(/* dst = */ items + at + 1, /* src = */ items + at, length - at);
         ++length;
@@ -98,7 +98,7 @@ struct List {
     }
 
     T& insert(const T &item, INT at) {
-        Assert(at >= 0 && at <= length);
+        Check(at >= 0 && at <= length);
         reserve(1);
         MemMove(/* dst = */ items + at + 1, /* src = */ items + at, length - at);
         items[at] = item;
@@ -107,9 +107,9 @@ struct List {
     }
 
     List& erase(INT start, INT count) {
-        Assert(start >= 0);
+        Check(start >= 0);
         auto end = start + count;
-        Assert(end <= length);
+        Check(end <= length);
         if (end < length) {
             MemMove(/*   dst = */ items + start, 
                     /*   src = */ items + end, 
@@ -119,6 +119,29 @@ struct List {
         return *this;
     }
 
+    INT indexOf(const T &item) const {
+        for (auto i = 0; i < length; i++) {
+            if (items[i] == item) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    bool contains(const T &item) const {
+        return indexOf(item) >= 0;
+    }
+
+    // Erases the first item equal to {item}; false if there is none.
+    bool remove(const T &item) {
+        auto at = indexOf(item);
+        if (at < 0) {
+            return false;
+        }
+        erase(at, 1);
+        return true;
+    }
+
     auto isEmpty() const {
         return length == 0;
     }
@@ -132,17 +155,17 @@ struct List {
     }
 
     T* end() const {
-        Assert(length > 0);
+        Check(length > 0);
         return items + length - 1;
     }
 
     T& first() const {
-        Assert(length > 0);
+        Check(length > 0);
         return items[0];
     }
 
     T& last() const {
-        Assert(length > 0);
+        Check(length > 0);
         return items[length - 1];
     }
 };
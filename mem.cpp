@@ -152,6 +152,13 @@ void* free(void *m) {
     HeapFree(GetProcessHeap(), 0, block);
     return nullptr;
 }
+
+Usage usage() {
+    AcquireSRWLockShared(&srw);
+    Usage result{ allocs, reallocs, frees, used, maxUsed };
+    ReleaseSRWLockShared(&srw);
+    return result;
+}
 } // namespace heap
 
 void Mem::dispose() {
@@ -164,6 +171,16 @@ void Mem::dispose() {
     }
 }
 
+INT64 Mem::size() {
+    INT64 result = 0;
+    AcquireSRWLockShared(&srw);
+    for (auto i = 0; i < length; ++i) {
+        result += slabs[i]->length;
+    }
+    ReleaseSRWLockShared(&srw);
+    return result;
+}
+
 auto getSizeOfSlabRequired(INT sizeRequested) {
     auto size = DEFAULT_SLAB_SIZE;
     while (sizeRequested >= size) {
@@ -202,7 +219,7 @@ void* Mem::doAlloc(INT size) {
 void* Mem::Slab::alloc(INT size) {
     auto result = (CHAR*)this + used;
     used += size;
-    Assert(used <= length);
+    Check(used <= length);
     return result;
 }
 
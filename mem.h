@@ -2,15 +2,22 @@
 
 namespace exy {
 namespace heap {
+struct Usage {
+    UINT64 allocs, reallocs, frees;
+    UINT64 used, maxUsed; // Bytes.
+};
+
 void initialize();
 void* alloc(INT n);
 void* realloc(void *m, INT n);
 void* free(void *m);
 void dispose();
+Usage usage();
 }
 
 struct Mem {
     void dispose();
+    INT64 size(); // Bytes in all the slabs, used or not.
 
     template<typename T>
     T* alloc(INT count = 1) {
@@ -33,6 +33,158 @@ auto removeUnderscores(const String &v) {
     return String{ buf, buflen };
 }
 
+// True if all 8 bytes of the little-endian chunk are ASCII '0'..'9'.
+auto isEightDigits(UINT64 v) {
+    return ((v & 0xF0F0F0F0F0F0F0F0ull) | (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+}
+
+// Converts 8 ASCII digits (first digit in the lowest byte) to their value with 3 multiplies.
+auto eightDigits(UINT64 v) {
+    v -= 0x3030303030303030ull;
+    v  = (v * 10) + (v >> 8);
+    v  = (((v & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+          (((v >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+    return UINT32(v);
+}
+
+auto digitOf(CHAR ch) {
+    if (ch >= '0' && ch <= '9') return UINT(ch - '0');
+    if (ch >= 'a' && ch <= 'f') return UINT(ch - 'a' + 10);
+    if (ch >= 'A' && ch <= 'F') return UINT(ch - 'A' + 10);
+    return MAXUINT;
+}
+
+// Accumulates the digits of _v_ in place, skipping '_'. Returns false when there are no
+// digits, a digit is out of range for _radix_ or the value does not fit in 64 bits.
+static bool toUInt64(const String &v, UINT radix, UINT64 &result) {
+    auto   pos = v.start();
+    auto   end = v.end();
+    UINT64 value = 0;
+    auto  digits = 0;
+    while (pos < end) {
+        if (radix == 10 && end - pos >= 8 && value < 100000000000ull) {
+            UINT64 chunk;
+            MemCopy(&chunk, pos);
+            if (isEightDigits(chunk)) {
+                value = value * 100000000ull + eightDigits(chunk);
+                digits += 8;
+                pos += 8;
+                continue;
+            }
+        }
+        auto ch = *pos++;
+        if (ch == '_') {
+            continue;
+        }
+        auto d = digitOf(ch);
+        if (d >= radix) {
+            return false;
+        }
+        if (value > (MAXUINT64 - d) / radix) {
+            return false;
+        }
+        value = value * radix + d;
+        ++digits;
+    }
+    result = value;
+    return digits > 0;
+}
+
+// Splits a decimal float literal into a mantissa of at most 19 digits and a base 10 exponent.
+static bool scanDecimalFloat(const String &v, UINT64 &mantissa, INT &exponent) {
+    auto   pos = v.start();
+    auto   end = v.end();
+    UINT64 m = 0;
+    auto   digits = 0;
+    auto   fraction = 0;
+    auto   isFraction = false;
+    for (; pos < end; ++pos) {
+        auto ch = *pos;
+        if (isDigit(ch)) {
+            if (++digits > 19) {
+                return false;
+            }
+            m = m * 10 + (ch - '0');
+            if (isFraction) {
+                ++fraction;
+            }
+        } else if (ch == '.' && !isFraction) {
+            isFraction = true;
+        } else if (ch != '_') {
+            break;
+        }
+    }
+    if (digits == 0) {
+        return false;
+    }
+    auto e = 0;
+    if (pos < end) {
+        if (*pos != 'e' && *pos != 'E') {
+            return false;
+        }
+        auto isNegative = false;
+        if (++pos < end && (*pos == '-' || *pos == '+')) {
+            isNegative = *pos++ == '-';
+        }
+        if (pos == end) {
+            return false;
+        }
+        for (; pos < end; ++pos) {
+            auto ch = *pos;
+            if (ch == '_') {
+                continue;
+            }
+            if (!isDigit(ch) || e > 9999) {
+                return false;
+            }
+            e = e * 10 + (ch - '0');
+        }
+        if (isNegative) {
+            e = -e;
+        }
+    }
+    mantissa = m;
+    exponent = e - fraction;
+    return true;
+}
+
+// Clinger's fast path: when both the mantissa and the power of 10 are exactly representable,
+// a single IEEE multiply or divide yields the correctly rounded result.
+static bool toDouble(const String &v, DOUBLE &result) {
+    static const DOUBLE powers[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    UINT64 mantissa{};
+    INT    exponent{};
+    if (!scanDecimalFloat(v, mantissa, exponent)) {
+        return false;
+    }
+    if (mantissa > (1ull << 53) || exponent < -22 || exponent > 22) {
+        return false;
+    }
+    auto d = DOUBLE(mantissa);
+    result = exponent < 0 ? d / powers[-exponent] : d * powers[exponent];
+    return true;
+}
+
+static bool toFloat(const String &v, FLOAT &result) {
+    static const FLOAT powers[] = {
+        1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+    };
+    UINT64 mantissa{};
+    INT    exponent{};
+    if (!scanDecimalFloat(v, mantissa, exponent)) {
+        return false;
+    }
+    if (mantissa > (1ull << 24) || exponent < -10 || exponent > 10) {
+        return false;
+    }
+    auto f = FLOAT(mantissa);
+    result = exponent < 0 ? f / powers[-exponent] : f * powers[exponent];
+    return true;
+}
+
 Node Parser::parseDecimal() {
     // dec [dec | '_']+
     auto     v = cursor.pos->sourceValue();
@@ -70,25 +222,20 @@ Node Parser::parseDecimal() {
         num.width = Num::Bits32; // Assume 32 bit integer.
     }
     auto node = mem.New<NumberSyntax>(*cursor.pos);
-    auto  buf = removeUnderscores(num.value);
-    if (buf.isEmpty()) {
-        err("decimal number too long: %s#<yellow>", &num.value);
+    UINT64 u64{};
+    if (!toUInt64(num.value, /* radix = */ 10, u64)) {
+        err("bad decimal number: %s#<yellow>", &num.value);
     } else if (num.isUnsigned) {
-        _set_errno(0);
-        CHAR *endPtr = nullptr;
-        auto     u64 = _strtoui64(buf.text, &endPtr, /* radix = */ 10);
-        if (errno != 0 || endPtr != buf.end()) {
-            err("bad decimal number: %s#<yellow>", &num.value);
-        } else if (num.width == Num::Bits8) {
+        if (num.width == Num::Bits8) {
             if (u64 > MAXUINT8) {
-                err("decimal value too large for UInt8: %s#<yellow> (%u64)", &buf, u64);
+                err("decimal value too large for UInt8: %s#<yellow> (%u64)", &num.value, u64);
             } else {
                 node->u64 = u64;
                 node->type = Keyword::UInt8;
             }
         } else if (num.width == Num::Bits16) {
             if (u64 > MAXUINT16) {
-                err("decimal value too large for UInt16: %s#<yellow>", &buf);
+                err("decimal value too large for UInt16: %s#<yellow>", &num.value);
             } else {
                 node->u64 = u64;
                 node->type = Keyword::UInt16;
@@ -99,7 +246,7 @@ Node Parser::parseDecimal() {
                     node->u64 = u64;
                     node->type = Keyword::UInt64;
                 } else {
-                    err("decimal value too large for UInt32: %s#<yellow>", &buf);
+                    err("decimal value too large for UInt32: %s#<yellow>", &num.value);
                 }
             } else {
                 node->u64 = u64;
@@ -112,21 +259,19 @@ Node Parser::parseDecimal() {
             Assert(0);
         }
     } else {
-        _set_errno(0);
-        CHAR *endPtr = nullptr;
-        auto     i64 = _strtoi64(buf.text, &endPtr, /* radix = */ 10);
-        if (errno != 0 || endPtr != buf.end()) {
+        auto i64 = INT64(u64);
+        if (u64 > MAXINT64) {
             err("bad decimal number: %s#<yellow>", &num.value);
         } else if (num.width == Num::Bits8) {
             if (i64 < MININT8 || i64 > MAXINT8) {
-                err("decimal value too large for Int8: %s#<yellow>", &buf);
+                err("decimal value too large for Int8: %s#<yellow>", &num.value);
             } else {
                 node->i64 = i64;
                 node->type = Keyword::Int8;
             }
         } else if (num.width == Num::Bits16) {
             if (i64 < MININT16 || i64 > MAXINT16) {
-                err("decimal value too large for Int16: %s#<yellow>", &buf);
+                err("decimal value too large for Int16: %s#<yellow>", &num.value);
             } else {
                 node->i64 = i64;
                 node->type = Keyword::Int16;
@@ -137,7 +282,7 @@ Node Parser::parseDecimal() {
                     node->i64 = i64;
                     node->type = Keyword::Int64;
                 } else {
-                    err("decimal value too large for Int32: %s#<yellow>", &buf);
+                    err("decimal value too large for Int32: %s#<yellow>", &num.value);
                 }
             } else {
                 node->i64 = i64;
@@ -203,25 +348,20 @@ Node Parser::parseHexadecimal() {
         num.width = Num::Bits32; // Assume 32 bit integer.
     }
     auto node = mem.New<NumberSyntax>(*cursor.pos);
-    auto  buf = removeUnderscores(num.value);
-    if (buf.isEmpty()) {
-        err("hexadecimal number too long: %s#<yellow>", &num.value);
+    UINT64 u64{};
+    if (!toUInt64(num.value, /* radix = */ 16, u64)) {
+        err("bad hexadecimal number: %s#<yellow>", &num.value);
     } else if (num.isUnsigned) {
-        _set_errno(0);
-        CHAR *endPtr = nullptr;
-        auto     u64 = _strtoui64(buf.text, &endPtr, /* radix = */ 16);
-        if (errno != 0 || endPtr != buf.end()) {
-            err("bad hexadecimal number: %s#<yellow>", &num.value);
-        } else if (num.width == Num::Bits8) {
+        if (num.width == Num::Bits8) {
             if (u64 > MAXUINT8) {
-                err("hexadecimal value too large for UInt8: %s#<yellow>", &buf);
+                err("hexadecimal value too large for UInt8: %s#<yellow>", &num.value);
             } else {
                 node->u64 = u64;
                 node->type = Keyword::UInt8;
             }
         } else if (num.width == Num::Bits16) {
             if (u64 > MAXUINT16) {
-                err("hexadecimal value too large for UInt16: %s#<yellow>", &buf);
+                err("hexadecimal value too large for UInt16: %s#<yellow>", &num.value);
             } else {
                 node->u64 = u64;
                 node->type = Keyword::UInt16;
@@ -232,7 +372,7 @@ Node Parser::parseHexadecimal() {
                     node->u64 = u64;
                     node->type = Keyword::UInt64;
                 } else {
-                    err("hexadecimal value too large for UInt32: %s#<yellow>", &buf);
+                    err("hexadecimal value too large for UInt32: %s#<yellow>", &num.value);
                 }
             } else {
                 node->u64 = u64;
@@ -245,21 +385,19 @@ Node Parser::parseHexadecimal() {
             Assert(0);
         }
     } else {
-        _set_errno(0);
-        CHAR *endPtr = nullptr;
-        auto     i64 = _strtoi64(buf.text, &endPtr, /* radix = */ 16);
-        if (errno != 0 || endPtr != buf.end()) {
+        auto i64 = INT64(u64);
+        if (u64 > MAXINT64) {
             err("bad hexadecimal number: %s#<yellow>", &num.value);
         } else if (num.width == Num::Bits8) {
             if (i64 < MININT8 || i64 > MAXINT8) {
-                err("hexadecimal value too large for Int8: %s#<yellow>", &buf);
+                err("hexadecimal value too large for Int8: %s#<yellow>", &num.value);
             } else {
                 node->i64 = i64;
                 node->type = Keyword::Int8;
             }
         } else if (num.width == Num::Bits16) {
             if (i64 < MININT16 || i64 > MAXINT16) {
-                err("hexadecimal value too large for Int16: %s#<yellow>", &buf);
+                err("hexadecimal value too large for Int16: %s#<yellow>", &num.value);
             } else {
                 node->i64 = i64;
                 node->type = Keyword::Int16;
@@ -270,7 +408,7 @@ Node Parser::parseHexadecimal() {
                     node->i64 = i64;
                     node->type = Keyword::Int64;
                 } else {
-                    err("hexadecimal value too large for Int32: %s#<yellow>", &buf);
+                    err("hexadecimal value too large for Int32: %s#<yellow>", &num.value);
                 }
             } else {
                 node->i64 = i64;
@@ -341,25 +479,20 @@ Node Parser::parseBinary() {
         num.width = Num::Bits32; // Assume 32 bit integer.
     }
     auto node = mem.New<NumberSyntax>(*cursor.pos);
-    auto  buf = removeUnderscores(num.value);
-    if (buf.isEmpty()) {
-        err("binary number too long: %s#<yellow>", &num.value);
+    UINT64 u64{};
+    if (!toUInt64(num.value, /* radix = */ 2, u64)) {
+        err("bad binary number: %s#<yellow>", &num.value);
     } else if (num.isUnsigned) {
-        _set_errno(0);
-        CHAR *endPtr = nullptr;
-        auto     u64 = _strtoui64(buf.text, &endPtr, /* radix = */ 2);
-        if (errno != 0 || endPtr != buf.end()) {
-            err("bad binary number: %s#<yellow>", &num.value);
-        } else if (num.width == Num::Bits8) {
+        if (num.width == Num::Bits8) {
             if (u64 > MAXUINT8) {
-                err("binary value too large for UInt8: %s#<yellow>", &buf);
+                err("binary value too large for UInt8: %s#<yellow>", &num.value);
             } else {
                 node->u64 = u64;
                 node->type = Keyword::UInt8;
             }
         } else if (num.width == Num::Bits16) {
             if (u64 > MAXUINT16) {
-                err("binary value too large for UInt16: %s#<yellow>", &buf);
+                err("binary value too large for UInt16: %s#<yellow>", &num.value);
             } else {
                 node->u64 = u64;
                 node->type = Keyword::UInt16;
@@ -370,7 +503,7 @@ Node Parser::parseBinary() {
                     node->u64 = u64;
                     node->type = Keyword::UInt64;
                 } else {
-                    err("binary value too large for UInt32: %s#<yellow>", &buf);
+                    err("binary value too large for UInt32: %s#<yellow>", &num.value);
                 }
             } else {
                 node->u64 = u64;
@@ -383,21 +516,19 @@ Node Parser::parseBinary() {
             Assert(0);
         }
     } else {
-        _set_errno(0);
-        CHAR *endPtr = nullptr;
-        auto     i64 = _strtoi64(buf.text, &endPtr, /* radix = */ 2);
-        if (errno != 0 || endPtr != buf.end()) {
+        auto i64 = INT64(u64);
+        if (u64 > MAXINT64) {
             err("bad binary number: %s#<yellow>", &num.value);
         } else if (num.width == Num::Bits8) {
             if (i64 < MININT8 || i64 > MAXINT8) {
-                err("binary value too large for Int8: %s#<yellow>", &buf);
+                err("binary value too large for Int8: %s#<yellow>", &num.value);
             } else {
                 node->i64 = i64;
                 node->type = Keyword::Int8;
             }
         } else if (num.width == Num::Bits16) {
             if (i64 < MININT16 || i64 > MAXINT16) {
-                err("binary value too large for Int16: %s#<yellow>", &buf);
+                err("binary value too large for Int16: %s#<yellow>", &num.value);
             } else {
                 node->i64 = i64;
                 node->type = Keyword::Int16;
@@ -408,7 +539,7 @@ Node Parser::parseBinary() {
                     node->i64 = i64;
                     node->type = Keyword::Int64;
                 } else {
-                    err("binary value too large for Int32: %s#<yellow>", &buf);
+                    err("binary value too large for Int32: %s#<yellow>", &num.value);
                 }
             } else {
                 node->i64 = i64;
@@ -477,25 +608,20 @@ Node Parser::parseOctal() {
         num.width = Num::Bits32; // Assume 32 bit integer.
     }
     auto node = mem.New<NumberSyntax>(*cursor.pos);
-    auto  buf = removeUnderscores(num.value);
-    if (buf.isEmpty()) {
-        err("octal number too long: %s#<yellow>", &num.value);
+    UINT64 u64{};
+    if (!toUInt64(num.value, /* radix = */ 8, u64)) {
+        err("bad octal number: %s#<yellow>", &num.value);
     } else if (num.isUnsigned) {
-        _set_errno(0);
-        CHAR *endPtr = nullptr;
-        auto u64 = _strtoui64(buf.text, &endPtr, /* radix = */ 8);
-        if (errno != 0 || endPtr != buf.end()) {
-            err("bad octal number: %s#<yellow>", &num.value);
-        } else if (num.width == Num::Bits8) {
+        if (num.width == Num::Bits8) {
             if (u64 > MAXUINT8) {
-                err("octal value too large for UInt8: %s#<yellow>", &buf);
+                err("octal value too large for UInt8: %s#<yellow>", &num.value);
             } else {
                 node->u64 = u64;
                 node->type = Keyword::UInt8;
             }
         } else if (num.width == Num::Bits16) {
             if (u64 > MAXUINT16) {
-                err("octal value too large for UInt16: %s#<yellow>", &buf);
+                err("octal value too large for UInt16: %s#<yellow>", &num.value);
             } else {
                 node->u64 = u64;
                 node->type = Keyword::UInt16;
@@ -506,7 +632,7 @@ Node Parser::parseOctal() {
                     node->u64 = u64;
                     node->type = Keyword::UInt64;
                 } else {
-                    err("octal value too large for UInt32: %s#<yellow>", &buf);
+                    err("octal value too large for UInt32: %s#<yellow>", &num.value);
                 }
             } else {
                 node->u64 = u64;
@@ -519,21 +645,19 @@ Node Parser::parseOctal() {
             Assert(0);
         }
     } else {
-        _set_errno(0);
-        CHAR *endPtr = nullptr;
-        auto     i64 = _strtoi64(buf.text, &endPtr, /* radix = */ 8);
-        if (errno != 0 || endPtr != buf.end()) {
+        auto i64 = INT64(u64);
+        if (u64 > MAXINT64) {
             err("bad octal number: %s#<yellow>", &num.value);
         } else if (num.width == Num::Bits8) {
             if (i64 < MININT8 || i64 > MAXINT8) {
-                err("octal value too large for Int8: %s#<yellow>", &buf);
+                err("octal value too large for Int8: %s#<yellow>", &num.value);
             } else {
                 node->i64 = i64;
                 node->type = Keyword::Int8;
             }
         } else if (num.width == Num::Bits16) {
             if (i64 < MININT16 || i64 > MAXINT16) {
-                err("octal value too large for Int16: %s#<yellow>", &buf);
+                err("octal value too large for Int16: %s#<yellow>", &num.value);
             } else {
                 node->i64 = i64;
                 node->type = Keyword::Int16;
@@ -544,7 +668,7 @@ Node Parser::parseOctal() {
                     node->i64 = i64;
                     node->type = Keyword::Int64;
                 } else {
-                    err("octal value too large for Int32: %s#<yellow>", &buf);
+                    err("octal value too large for Int32: %s#<yellow>", &num.value);
                 }
             } else {
                 node->i64 = i64;
@@ -593,6 +717,16 @@ Node Parser::parseFloat() {
         num.width = Num::Bits64; // Assume f64.
     }
     auto node = mem.New<NumberSyntax>(*cursor.pos);
+    if (num.width == Num::Bits32 && toFloat(num.value, node->f32)) {
+        node->type = Keyword::Float;
+        cursor.advance(); // Past number.
+        return node;
+    }
+    if (num.width == Num::Bits64 && toDouble(num.value, node->f64)) {
+        node->type = Keyword::Double;
+        cursor.advance(); // Past number.
+        return node;
+    }
     auto  buf = removeUnderscores(num.value);
     if (buf.isEmpty()) {
         err("floating-point number too long: %s#<yellow>", &num.value);
@@ -657,36 +791,29 @@ Node Parser::parseDecimalFloat() {
         num.width = Num::Bits64; // Assume f64.
     }
     auto node = mem.New<NumberSyntax>(*cursor.pos);
-    auto  buf = removeUnderscores(num.value);
-    if (buf.isEmpty()) {
-        err("decimal number too long: %s#<yellow>", &num.value);
+    UINT64 u64{};
+    if (!toUInt64(num.value, /* radix = */ 10, u64)) {
+        err("bad decimal number: %s#<yellow>", &num.value);
     } else {
-        _set_errno(0);
-        CHAR *endPtr = nullptr;
-        auto     u64 = _strtoui64(buf.text, &endPtr, /* radix = */ 10);
-        if (errno != 0 || endPtr != buf.end()) {
-            err("bad decimal number: %s#<yellow>", &num.value);
-        } else {
-            switch (num.width) {
-                case Num::Bits64: {
+        switch (num.width) {
+            case Num::Bits64: {
+                node->f64 = meta::reinterpret<DOUBLE>(u64);
+                node->type = Keyword::Double;
+            } break;
+            case Num::Bits32: if (u64 > MAXUINT32) {
+                if (vwidth == nullptr) {
                     node->f64 = meta::reinterpret<DOUBLE>(u64);
                     node->type = Keyword::Double;
-                } break;
-                case Num::Bits32: if (u64 > MAXUINT32) {
-                    if (vwidth == nullptr) {
-                        node->f64 = meta::reinterpret<DOUBLE>(u64);
-                        node->type = Keyword::Double;
-                    } else {
-                        err("decimal bit value too large for f32: %s#<yellow>", &buf);
-                    }
                 } else {
-                    node->f32 = meta::reinterpret<FLOAT>(UINT32(u64));
-                    node->type = Keyword::Float;
-                } break;
-                default:
-                    Assert(0);
-                    break;
-            }
+                    err("decimal bit value too large for f32: %s#<yellow>", &num.value);
+                }
+            } else {
+                node->f32 = meta::reinterpret<FLOAT>(UINT32(u64));
+                node->type = Keyword::Float;
+            } break;
+            default:
+                Assert(0);
+                break;
         }
     }
     cursor.advance(); // Past number.
@@ -737,36 +864,29 @@ Node Parser::parseHexadecimalFloat() {
         num.width = Num::Bits64; // Assume f64.
     }
     auto node = mem.New<NumberSyntax>(*cursor.pos);
-    auto  buf = removeUnderscores(num.value);
-    if (buf.isEmpty()) {
-        err("hexadecimal number too long: %s#<yellow>", &num.value);
+    UINT64 u64{};
+    if (!toUInt64(num.value, /* radix = */ 16, u64)) {
+        err("bad hexadecimal number: %s#<yellow>", &num.value);
     } else {
-        _set_errno(0);
-        CHAR *endPtr = nullptr;
-        auto     u64 = _strtoui64(buf.text, &endPtr, /* radix = */ 16);
-        if (errno != 0 || endPtr != buf.end()) {
-            err("bad hexadecimal number: %s#<yellow>", &num.value);
-        } else {
-            switch (num.width) {
-                case Num::Bits64: {
+        switch (num.width) {
+            case Num::Bits64: {
+                node->f64 = meta::reinterpret<DOUBLE>(u64);
+                node->type = Keyword::Double;
+            } break;
+            case Num::Bits32: if (u64 > MAXUINT32) {
+                if (vwidth == nullptr) {
                     node->f64 = meta::reinterpret<DOUBLE>(u64);
                     node->type = Keyword::Double;
-                } break;
-                case Num::Bits32: if (u64 > MAXUINT32) {
-                    if (vwidth == nullptr) {
-                        node->f64 = meta::reinterpret<DOUBLE>(u64);
-                        node->type = Keyword::Double;
-                    } else {
-                        err("hexadecimal bit value too large for f32: %s#<yellow>", &buf);
-                    }
                 } else {
-                    node->f32 = meta::reinterpret<FLOAT>(UINT32(u64));
-                    node->type = Keyword::Float;
-                } break;
-                default:
-                    Assert(0);
-                    break;
-            }
+                    err("hexadecimal bit value too large for f32: %s#<yellow>", &num.value);
+                }
+            } else {
+                node->f32 = meta::reinterpret<FLOAT>(UINT32(u64));
+                node->type = Keyword::Float;
+            } break;
+            default:
+                Assert(0);
+                break;
         }
     }
     cursor.advance(); // Past number.
@@ -822,36 +942,29 @@ Node Parser::parseBinaryFloat() {
         num.width = Num::Bits64; // Assume f64.
     }
     auto node = mem.New<NumberSyntax>(*cursor.pos);
-    auto  buf = removeUnderscores(num.value);
-    if (buf.isEmpty()) {
-        err("binary number too long: %s#<yellow>", &num.value);
+    UINT64 u64{};
+    if (!toUInt64(num.value, /* radix = */ 2, u64)) {
+        err("bad binary number: %s#<yellow>", &num.value);
     } else {
-        _set_errno(0);
-        CHAR *endPtr = nullptr;
-        auto     u64 = _strtoui64(buf.text, &endPtr, /* radix = */ 2);
-        if (errno != 0 || endPtr != buf.end()) {
-            err("bad binary number: %s#<yellow>", &num.value);
-        } else {
-            switch (num.width) {
-                case Num::Bits64: {
+        switch (num.width) {
+            case Num::Bits64: {
+                node->f64 = meta::reinterpret<DOUBLE>(u64);
+                node->type = Keyword::Double;
+            } break;
+            case Num::Bits32: if (u64 > MAXUINT32) {
+                if (vwidth == nullptr) {
                     node->f64 = meta::reinterpret<DOUBLE>(u64);
                     node->type = Keyword::Double;
-                } break;
-                case Num::Bits32: if (u64 > MAXUINT32) {
-                    if (vwidth == nullptr) {
-                        node->f64 = meta::reinterpret<DOUBLE>(u64);
-                        node->type = Keyword::Double;
-                    } else {
-                        err("binary bit value too large for f32: %s#<yellow>", &buf);
-                    }
                 } else {
-                    node->f32 = meta::reinterpret<FLOAT>(UINT32(u64));
-                    node->type = Keyword::Float;
-                } break;
-                default:
-                    Assert(0);
-                    break;
-            }
+                    err("binary bit value too large for f32: %s#<yellow>", &num.value);
+                }
+            } else {
+                node->f32 = meta::reinterpret<FLOAT>(UINT32(u64));
+                node->type = Keyword::Float;
+            } break;
+            default:
+                Assert(0);
+                break;
         }
     }
     cursor.advance(); // Past number.
@@ -907,39 +1020,262 @@ Node Parser::parseOctalFloat() {
         num.width = Num::Bits64; // Assume f64.
     }
     auto node = mem.New<NumberSyntax>(*cursor.pos);
-    auto  buf = removeUnderscores(num.value);
-    if (buf.isEmpty()) {
-        err("octal number too long: %s#<yellow>", &num.value);
+    UINT64 u64{};
+    if (!toUInt64(num.value, /* radix = */ 8, u64)) {
+        err("bad octal number: %s#<yellow>", &num.value);
     } else {
-        _set_errno(0);
-        CHAR *endPtr = nullptr;
-        auto     u64 = _strtoui64(buf.text, &endPtr, /* radix = */ 8);
-        if (errno != 0 || endPtr != buf.end()) {
-            err("bad octal number: %s#<yellow>", &num.value);
-        } else {
-            switch (num.width) {
-                case Num::Bits64: {
+        switch (num.width) {
+            case Num::Bits64: {
+                node->f64 = meta::reinterpret<DOUBLE>(u64);
+                node->type = Keyword::Double;
+            } break;
+            case Num::Bits32: if (u64 > MAXUINT32) {
+                if (vwidth == nullptr) {
                     node->f64 = meta::reinterpret<DOUBLE>(u64);
                     node->type = Keyword::Double;
-                } break;
-                case Num::Bits32: if (u64 > MAXUINT32) {
-                    if (vwidth == nullptr) {
-                        node->f64 = meta::reinterpret<DOUBLE>(u64);
-                        node->type = Keyword::Double;
-                    } else {
-                        err("octal bit value too large for f32: %s#<yellow>", &buf);
-                    }
                 } else {
-                    node->f32 = meta::reinterpret<FLOAT>(UINT32(u64));
-                    node->type = Keyword::Float;
-                } break;
-                default:
-                    Assert(0);
-                    break;
-            }
+                    err("octal bit value too large for f32: %s#<yellow>", &num.value);
+                }
+            } else {
+                node->f32 = meta::reinterpret<FLOAT>(UINT32(u64));
+                node->type = Keyword::Float;
+            } break;
+            default:
+                Assert(0);
+                break;
         }
     }
     cursor.advance(); // Past number.
     return node;
 }
+//----------------------------------------------------------
+// exc --check-numbers
+// Round-trips {toUInt64}, {toDouble} and {toFloat} against the C runtime. Every 8-digit chunk goes
+// through the SWAR path; edge values are checked in each radix with '_' placed after every digit,
+// doubled and trailing. A float literal the fast path takes must convert to the same bits as
+// {strtod} or {strtof}; what it declines is left to them by {Parser::parseFloat}.
+struct NumberCheck {
+    UINT64 seed = 0x2545F4914F6CDD1Dull;
+    INT64  checks{};
+    INT64  fastPaths{};
+    INT    failures{};
+    String literal{};
+
+    void dispose() {
+        literal.dispose();
+    }
+
+    UINT64 next() { // xorshift64
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        return seed;
+    }
+
+    void fail(const CHAR *what, const String &v) {
+        if (++failures <= 20) {
+            traceln("%c#<red>: %s#<yellow>", what, &v);
+        }
+    }
+
+    void uint64(const String &v, UINT radix) {
+        ++checks;
+        auto stripped = removeUnderscores(v);
+        CHAR  *endPtr = nullptr;
+        _set_errno(0);
+        auto expected = _strtoui64(stripped.text, &endPtr, radix);
+        auto isExpected = stripped.isNotEmpty() && errno == 0 && endPtr == stripped.end();
+        UINT64 actual{};
+        auto isActual = toUInt64(v, radix, actual);
+        if (isActual != isExpected || (isActual && actual != expected)) {
+            fail("toUInt64", v);
+        }
+    }
+
+    // {digits} as written, with '_' or '__' after every {gap}-th character that is followed by
+    // another {isaDigit}, and with a trailing '_'.
+    template<typename TCheck>
+    void placements(const CHAR *digits, bool (*isaDigit)(CHAR), TCheck check) {
+        String v{ digits };
+        check(v);
+        for (auto gap = 1; gap < v.length; gap++) {
+            for (auto sep = 1; sep <= 2; sep++) {
+                literal.length = 0;
+                for (auto i = 0; i < v.length; i++) {
+                    literal.append(v.text + i, 1);
+                    if ((i + 1) % gap == 0 && i + 1 < v.length && isaDigit(v.text[i]) && isaDigit(v.text[i + 1])) {
+                        literal.append("__", sep);
+                    }
+                }
+                check(literal);
+            }
+        }
+        literal.length = 0;
+        literal.append(v).append(S("_"));
+        check(literal);
+    }
+
+    void uint64(UINT64 value, UINT radix) {
+        CHAR digits[72]{};
+        _ui64toa_s(value, digits, _countof(digits), INT(radix));
+        placements(digits, isHexDigit, [&](const String &v) { uint64(v, radix); });
+        // One more digit overflows unless {value} is small enough.
+        auto length = cstrlen(digits);
+        digits[length] = '0';
+        digits[length + 1] = '\0';
+        uint64(String{ digits }, radix);
+    }
+
+    // Every zero-padded 8-digit chunk, through {isEightDigits} and {eightDigits}.
+    void eightDigitChunks() {
+        CHAR digits[9]{ '0', '0', '0', '0', '0', '0', '0', '0', '\0' };
+        const String v{ digits, 8 };
+        for (UINT64 value = 0; value < 100000000ull; value++) {
+            UINT64 actual{};
+            ++checks;
+            if (!toUInt64(v, 10, actual) || actual != value) {
+                fail("toUInt64", v);
+            }
+            for (auto i = 7; i >= 0 && ++digits[i] > '9'; i--) {
+                digits[i] = '0';
+            }
+        }
+    }
+
+    void integers() {
+        static const UINT radixes[] = { 10, 16, 2, 8 };
+        static const Num::Bits widths[] = { Num::Bits8, Num::Bits16, Num::Bits32, Num::Bits64 };
+        for (auto r = 0; r < _countof(radixes); r++) {
+            auto radix = radixes[r];
+            uint64(0, radix);
+            uint64(1, radix);
+            // Overflow of each width, unsigned and signed.
+            for (auto w = 0; w < _countof(widths); w++) {
+                auto bits = INT(widths[w]);
+                auto umax = bits == 64 ? MAXUINT64 : (1ull << bits) - 1;
+                auto imax = umax >> 1;
+                uint64(umax, radix);
+                uint64(imax, radix);
+                uint64(imax + 1, radix);
+                if (bits < 64) {
+                    uint64(umax + 1, radix);
+                }
+            }
+        }
+        // 19 digits always fit and 20 digits may not: the SWAR path stops at 11 digits for that.
+        static const CHAR *const decimals[] = {
+            "99999999", "100000000", "9999999999999999", "10000000000000000",
+            "99999999999", "100000000000", "999999999999", "1000000000000000000", "9999999999999999999",
+            "10000000000000000000", "18446744073709551615", "18446744073709551616", "18446744073709551619",
+            "18446744073709551620", "99999999999999999999", "100000000000000000000",
+            "00000000000000000000000000000018446744073709551615", "0000000000000000000000000000000000000000",
+        };
+        for (auto i = 0; i < _countof(decimals); i++) {
+            placements(decimals[i], isDigit, [&](const String &v) { uint64(v, 10); });
+        }
+        for (auto i = 0; i < 100000; i++) {
+            auto value = next() >> (next() & 63);
+            uint64(value, 10);
+            uint64(value, 16);
+        }
+        eightDigitChunks();
+    }
+
+    // {isFast}: 1 if the fast path must take {v}, 0 if it must decline it, -1 if either will do.
+    void float64(const String &v, INT isFast) {
+        ++checks;
+        auto stripped = removeUnderscores(v);
+        DOUBLE actual{};
+        if (!toDouble(v, actual)) {
+            if (isFast == 1) {
+                fail("toDouble declined", v);
+            }
+            return;
+        }
+        ++fastPaths;
+        _set_errno(0);
+        auto expected = strtod(stripped.text, nullptr);
+        if (isFast == 0) {
+            fail("toDouble took", v);
+        } else if (errno != 0 || meta::reinterpret<UINT64>(actual) != meta::reinterpret<UINT64>(expected)) {
+            fail("toDouble", v);
+        }
+    }
+
+    void float32(const String &v, INT isFast) {
+        ++checks;
+        auto stripped = removeUnderscores(v);
+        FLOAT actual{};
+        if (!toFloat(v, actual)) {
+            if (isFast == 1) {
+                fail("toFloat declined", v);
+            }
+            return;
+        }
+        ++fastPaths;
+        _set_errno(0);
+        auto expected = strtof(stripped.text, nullptr);
+        if (isFast == 0) {
+            fail("toFloat took", v);
+        } else if (errno != 0 || meta::reinterpret<UINT32>(actual) != meta::reinterpret<UINT32>(expected)) {
+            fail("toFloat", v);
+        }
+    }
+
+    void floats() {
+        // Clinger's limits: a mantissa of at most 2^53 (2^24) and a power of at most 10^22 (10^10).
+        struct Edge { const CHAR *literal; INT isDoubleFast, isFloatFast; };
+        static const Edge edges[] = {
+            { "9007199254740992", 1, 0 },      { "9007199254740993", 0, 0 },
+            { "9007199254740992e22", 1, 0 },   { "9007199254740992e-22", 1, 0 },
+            { "1e22", 1, 0 },                  { "1e23", 0, 0 },
+            { "1e-22", 1, 0 },                 { "1e-23", 0, 0 },
+            { "16777216", 1, 1 },              { "16777217", 1, 0 },
+            { "1e10", 1, 1 },                  { "1e11", 1, 0 },
+            { "1e-10", 1, 1 },                 { "1e-11", 1, 0 },
+            { "0.1", 1, 1 },                   { "3.14159", 1, 1 },
+            { "123456789012345678.9", 0, 0 },  { "1234567890123456789.0", 0, 0 },
+            { "0.000000000000000001", 1, 0 },  { "1.0e+0", 1, 1 },
+        };
+        for (auto i = 0; i < _countof(edges); i++) {
+            auto &edge = edges[i];
+            placements(edge.literal, isDigit, [&](const String &v) {
+                float64(v, edge.isDoubleFast);
+                float32(v, edge.isFloatFast);
+            });
+        }
+        for (auto i = 0; i < 200000; i++) {
+            auto digits = INT(next() % 19) + 1;
+            UINT64 mantissa = next() % 10000000000000000000ull;
+            CHAR text[64]{};
+            _ui64toa_s(mantissa, text, _countof(text), 10);
+            auto length = cstrlen(text);
+            length = min(length, digits);
+            auto point = INT(next() % length) + 1;
+            auto exponent = INT(next() % 51) - 25;
+            literal.length = 0;
+            literal.append(text, point).append(S(".")).append(text + point, length - point);
+            if (point == length) {
+                literal.append(S("0"));
+            }
+            literal.append(S("e"));
+            literal.appendInt(exponent);
+            float64(literal, -1);
+            float32(literal, -1);
+        }
+    }
+};
+
+INT checkNumbers() {
+    NumberCheck check{};
+    auto start = stats::microseconds();
+    check.integers();
+    check.floats();
+    traceln("%i64#<green> number literals checked (%i64#<green> through the float fast path) in %i64 µs: "
+            "%i#<red> failure%c", check.checks, check.fastPaths, stats::microseconds() - start,
+            check.failures, check.failures == 1 ? "" : "s");
+    auto failures = check.failures;
+    check.dispose();
+    return failures == 0 ? 0 : -1;
+}
 } // namespace exy
\ No newline at end of file
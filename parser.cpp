@@ -133,7 +133,7 @@ bool Parser::Cursor::hasNewLineBefore(Pos cur) {
 
 Parser::Parser(SyntaxFile &file)
     : file(file), cursor(file.src.tokens.start(), file.src.tokens.end()), 
-    mem(compiler.syntaxTree->mem) {
+    mem(file.mem) {
     Assert(is.EndOfFile(cursor.end));
 }
 
@@ -563,7 +563,9 @@ Node Parser::parseFunction(Node modifiers) {
             node->body = mem.New<EmptySyntax>(*cursor.pos);
         }
     } else if (is.OpenCurly(cursor.pos)) {
-        node->body = parseBlock(nullptr);
+        if (!compiler.config.lazyFunctionBodies || !skipFunctionBody(node)) {
+            node->body = parseBlock(nullptr);
+        }
     } else if (is.SemiColon(cursor.pos)) {
         node->body = mem.New<EmptySyntax>(*cursor.pos);
         cursor.advance(); // Past ';'
@@ -582,6 +584,71 @@ Node Parser::parseFunction(Node modifiers) {
     return node;
 }
 
+// Stands an empty block in for the '{' ... '}' body of {fn} and moves past it.
+// The '}' is found through the enclosures recorded by the {TokenProcessor};
+// quoted text is jumped over the same way. {awaits}, {yields} and {returns}
+// are counted from keywords. A body that nests a function is not skipped
+// because the nested function owns some of those keywords.
+bool Parser::skipFunctionBody(FunctionSyntax *fn) {
+    auto     &src = file.src;
+    const auto open = INT(cursor.pos - src.tokens.items);
+    auto      idx = src.enclosures.indexOf(UINT(open + 1));
+    if (idx < 0) {
+        return false; // Unmatched. Let {parseBlock} report it.
+    }
+    const auto close = src.enclosures.items[idx].value;
+    INT awaits = 0, yields = 0, returns = 0;
+    for (auto i = open + 1; i < close; i++) {
+        auto pos = src.tokens.items + i;
+        if (is.Quote(pos) || is.HashOpenCurly(pos)) {
+            auto j = src.enclosures.indexOf(UINT(i + 1));
+            if (j < 0) {
+                return false;
+            }
+            i = src.enclosures.items[j].value;
+        } else if (is.Function(pos) || is.kwWith(pos)) {
+            return false;
+        } else if (is.kwReturn(pos)) {
+            ++returns;
+        } else if (is.kwYield(pos)) {
+            ++yields;
+        } else if (is.kwAwait(pos)) {
+            ++awaits;
+        }
+    }
+    auto block = mem.New<BlockSyntax>(nullptr, *cursor.pos);
+    block->close = src.tokens.items + close;
+    fn->body     = block;
+    fn->isLazy   = true;
+    fn->awaits  += awaits;
+    fn->yields  += yields;
+    fn->returns += returns;
+    cursor.pos  = block->close;
+    cursor.next = block->close + 1;
+    cursor.skipWhiteSpace();
+    cursor.advance(); // Past '}'.
+    return true;
+}
+
+// Parses the body skipped by {skipFunctionBody}, on the thread that began {fn->lazyParse}.
+// The keyword counts were taken by the skip and other threads may be reading them, so the
+// parse does not count them again.
+void Parser::parseLazyBody(FunctionSyntax *fn) {
+    Check(fn->isLazy && fn->lazyParse.isBusy());
+    auto placeholder = (BlockSyntax*)fn->body;
+    cursor.pos  = &placeholder->pos;
+    cursor.next = cursor.pos + 1;
+    cursor.skipWhiteSpace();
+    currentFunction = { &currentFunction, fn };
+    isCounted = true;
+    fn->body = parseBlock(nullptr);
+    isCounted = false;
+    if (currentFunction.prev) {
+        currentFunction = *currentFunction.prev;
+    }
+    placeholder->dispose();
+}
+
 void Parser::parseFunctionName(FunctionSyntax *node) {
     if (is.kwUrlHandler(&node->pos)) {
         parseUrlHandlerName(node);
@@ -1112,7 +1179,9 @@ Node Parser::parseReturn() {
         node->expression = parseExpressionList(ctxLhsExpr); // Allow '{' to be an initializer.
     }
     if (auto fn = currentFunction.node) {
-        ++fn->returns;
+        if (!isCounted) {
+            ++fn->returns;
+        }
     }
     return node;
 }
@@ -1126,7 +1195,9 @@ Node Parser::parseYield() {
     }
     node->expression = parseExpression(ctxRhsExpr);
     if (auto fn = currentFunction.node) {
-        ++fn->yields;
+        if (!isCounted) {
+            ++fn->yields;
+        }
     } else {
         syntax_error(node, "%kw outside of a function", node->pos.keyword);
     }
@@ -1371,7 +1442,9 @@ Node Parser::parseAwaitFor() {
             auto forin = (ForInSyntax*)node;
             forin->kwAwait = kwAwait;
             if (auto fn = currentFunction.node) {
-                ++fn->awaits;
+                if (!isCounted) {
+                    ++fn->awaits;
+                }
             }
             return forin;
         }
@@ -1479,7 +1552,7 @@ Node Parser::parseExpressionList(Ctx ctx) {
 Node Parser::parseExpression(Ctx ctx) {
     if (((ctx & ctxTypeName) != 0) && is.OpenCurly(cursor.pos)) {
         // '{' is the first token in a typename context. Parse as object.
-        traceln("parseExpression");
+        logln(Parser, Trace, "parseExpression");
         Assert(0);
     }
     if (auto node = parseUnary(ctx)) {
@@ -1634,7 +1707,9 @@ Node Parser::parseUnary(Ctx ctx) {
                 case Keyword::Await: {
                     inner = mem.New<UnaryPrefixSyntax>(*cursor.pos);
                     if (auto fn = currentFunction.node) {
-                        ++fn->awaits;
+                        if (!isCounted) {
+                            ++fn->awaits;
+                        }
                     } else {
                         syntax_error(inner, "%kw outside of a function", inner->pos.keyword);
                     }
@@ -30,6 +30,7 @@ struct Parser {
 	void dispose();
 
 	void run();
+	void parseLazyBody(FunctionSyntax*);
 private:
 	enum Ctx {
 		ctxLhsExpr  = 0x01, // Assume that '{' starts an initializer.
@@ -66,7 +67,9 @@ private:
 		FunctionSyntax  *node = nullptr;
 	};
 	CurrentFunction currentFunction{};
+	bool            isCounted{}; // The keywords of the body being parsed were counted when it was skipped.
 	Node parseFunction(Node modifiers);
+	bool skipFunctionBody(FunctionSyntax*);
 	void parseFunctionName(FunctionSyntax*);
 	void parseUrlHandlerName(FunctionSyntax*);
 	void parseFunctionOperatorName(FunctionSyntax*);
@@ -141,5 +144,8 @@ private:
 	Node parseHexadecimalFloat();
 	Node parseBinaryFloat();
 	Node parseOctalFloat();
-};
-} // namespace exy
+}};
+
+// parse_number.cpp: exc --check-numbers
+INT checkNumbers();
+} // namespace exy
\ No newline at end of file
@@ -50,7 +50,33 @@ U reinterpret(T t) {
 } // namespace meta
 } // namespace exy
 
+/*  How much is checked, from '/D EXY_CHECKS=n'; by default 2 in _DEBUG builds and 0 otherwise.
+*     0 (release)  {Assert} and {Check} compile to nothing; {Assume} becomes an optimizer hint.
+*     1 (hardened) {Check}, the cheap bounds checks of {List}, {Dict} and the like, fails fast.
+*     2 (debug)    Everything breaks into the debugger.
+*   {Assume} is only for what is true by construction, e.g. a remainder being less than its divisor.
+*/
+#ifndef EXY_CHECKS
+#ifdef _DEBUG
+#define EXY_CHECKS 2
+#else
+#define EXY_CHECKS 0
+#endif
+#endif
+
+#if EXY_CHECKS >= 2
 #define Assert(expr) do { if (!(expr)) DebugBreak(); } while (0)
+#define Check(expr)  Assert(expr)
+#define Assume(expr) Assert(expr)
+#elif EXY_CHECKS == 1
+#define Assert(expr) do { (void)sizeof(!(expr)); } while (0)
+#define Check(expr)  do { if (!(expr)) __fastfail(FAST_FAIL_RANGE_CHECK_FAILURE); } while (0)
+#define Assume(expr) __assume(expr)
+#else
+#define Assert(expr) do { (void)sizeof(!(expr)); } while (0)
+#define Check(expr)  Assert(expr)
+#define Assume(expr) __assume(expr)
+#endif
 #define OsError(function, msg, ...) Assert(0)
 #define UNREACHABLE() do { Assert(0); ExitProcess(0); } while (0)
 
@@ -79,6 +105,8 @@ static thread_local CHAR tmpbuf[tmpbufcap]{};
 #include "list.h"
 #include "dict.h"
 #include "console.h"
+#include "stats.h"
+#include "diagnostics.h"
 #include "aio.h"
 
 namespace exy {
@@ -106,7 +134,11 @@ void ldispose(Dict<T*> &dict) {
 }
 
 struct Status {
-    enum { Idle, Busy, Done } value;
+    enum : LONG { Idle, Busy, Done };
+    struct Binder;
+
+    volatile LONG    value;
+    Binder *volatile owner; // The thread that moved {this} from Idle to Busy.
 
     auto isIdle() const { return value == Idle; }
     auto isBusy() const { return value == Busy; }
@@ -115,8 +147,10 @@ struct Status {
     auto isNotIdle() const { return value > Idle; }
     auto isNotDone() const { return value < Done; }
 
-    auto begin() { if (value == Idle) { value = Busy; return true; } return false; }
-    auto finish() { Assert(value == Busy); value = Done; }
+    // aio.cpp
+    bool begin();  // Idle → Busy. If another thread is busy with {this}, waits until it is done.
+    void finish(); // Busy → Done, waking any waiters.
+    void wait();   // Returns when done or if this thread is the one to break a cycle of waiting threads.
 };
 } // namespace exy
 
@@ -0,0 +1,337 @@
+#include "pch.h"
+#include "server.h"
+
+#include "src.h"
+#include "syntax.h"
+
+#define PIPE_NAME        "\\\\.\\pipe\\exc"
+#define PIPE_BUFFER_SIZE 0x1000
+
+namespace exy {
+using stats::microseconds;
+//----------------------------------------------------------
+/*  A request is one message: a byte saying whether the client's console shows colors, then the client's
+*   arguments, each ending in '\0': '\1' "--compile" '\0' "--max-errors" '\0' "5" '\0'. The server answers with
+*   {Frame::Text} messages carrying what it prints while compiling, then one {Frame::Reply}.
+*/
+enum class Frame : CHAR {
+    Text  = 'T', // Followed by up to {PIPE_BUFFER_SIZE} - 1 bytes of console output.
+    Reply = 'R'  // Followed by a {Reply}.
+};
+
+struct Reply {
+    INT   errors;
+    INT64 elapsed; // Microseconds spent compiling.
+};
+//----------------------------------------------------------
+// Sends what the console prints while a request is compiled to the client, which prints it in turn.
+struct PipeFormatSink : FormatSink {
+    HANDLE     pipe{ INVALID_HANDLE_VALUE };
+    OVERLAPPED overlapped{};
+    bool       isClientaTerminal{};
+    bool       isBroken{}; // The client went away: the rest of the request's output is dropped.
+
+    bool isaTerminal() const override { return isClientaTerminal; }
+
+    bool send(Frame frame, const void *v, INT vlen) {
+        Assert(vlen < PIPE_BUFFER_SIZE);
+        if (isBroken) {
+            return false;
+        }
+        CHAR  message[PIPE_BUFFER_SIZE];
+        DWORD written{};
+        message[0] = CHAR(frame);
+        MemCopy(message + 1, (const CHAR*)v, vlen);
+        auto ok = WriteFile(pipe, message, vlen + 1, &written, &overlapped);
+        if (ok == FALSE && GetLastError() != ERROR_IO_PENDING) {
+            isBroken = true;
+        } else if (GetOverlappedResult(pipe, &overlapped, &written, TRUE) == FALSE) {
+            isBroken = true;
+        }
+        return !isBroken;
+    }
+protected:
+    void doWrite(const CHAR *v, INT vlen) override {
+        while (vlen > 0 && !isBroken) {
+            auto length = min(vlen, PIPE_BUFFER_SIZE - 1);
+            send(Frame::Text, v, length);
+            v    += length;
+            vlen -= length;
+        }
+    }
+};
+//----------------------------------------------------------
+// The server keeps the thread pool, the identifier table and the source and
+// syntax trees alive between requests. A request re-tokenizes and re-parses
+// only the files modified since the previous one and rebuilds the typed tree.
+struct Server {
+    INT             argc;   // The server's own command line, whose options each request starts from.
+    const CHAR    **argv;
+    HANDLE          pipe{ INVALID_HANDLE_VALUE };
+    OVERLAPPED      overlapped{};
+    PipeFormatSink  output{};
+    SourceWatcher   watcher{};
+    INT             requests{};
+    bool            isLazy{};  // Whether the cached syntax tree was parsed with '--lazy'.
+    bool            isRunning{};
+
+    bool initialize() {
+        traceln("Starting compile server on %c#<yellow>", PIPE_NAME);
+        ids.initialize();
+        if (!compiler.config.initialize()) {
+            return false;
+        }
+        watcher.initialize();
+        overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+        output.overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+        if (overlapped.hEvent == nullptr || output.overlapped.hEvent == nullptr) {
+            OsError("CreateEvent", nullptr);
+            ++compiler.errors;
+        }
+        pipe = CreateNamedPipe(PIPE_NAME,
+                               PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+                               PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+                               1, PIPE_BUFFER_SIZE, PIPE_BUFFER_SIZE, 0, nullptr);
+        if (pipe == INVALID_HANDLE_VALUE) {
+            OsError("CreateNamedPipe", nullptr);
+            ++compiler.errors;
+        }
+        output.pipe = pipe;
+        isRunning = compiler.errors == 0;
+        return isRunning;
+    }
+
+    void dispose() {
+        traceln("Stopping compile server after %i#<green> request%c", requests, requests == 1 ? "" : "s");
+        watcher.dispose();
+        if (pipe != INVALID_HANDLE_VALUE) {
+            CloseHandle(pipe);
+            pipe = INVALID_HANDLE_VALUE;
+        }
+        if (overlapped.hEvent != nullptr) {
+            CloseHandle(overlapped.hEvent);
+            overlapped.hEvent = nullptr;
+        }
+        if (output.overlapped.hEvent != nullptr) {
+            CloseHandle(output.overlapped.hEvent);
+            output.overlapped.hEvent = nullptr;
+        }
+        compiler.dispose();
+    }
+
+    // Waits for the next client while noting source folder changes.
+    void serve() {
+        if (!connect()) {
+            isRunning = false;
+            return;
+        }
+        HANDLE handles[MAXIMUM_WAIT_OBJECTS]{ overlapped.hEvent };
+        auto watches = watcher.watches.length;
+        for (auto i = 0; i < watches; i++) {
+            handles[i + 1] = watcher.event(i);
+        }
+        while (true) {
+            auto res = WaitForMultipleObjects(1 + watches, handles, FALSE, INFINITE);
+            if (res == WAIT_OBJECT_0) {
+                return respond();
+            }
+            auto index = INT(res - WAIT_OBJECT_0) - 1;
+            if (index >= 0 && index < watches) {
+                watcher.notify(index);
+                continue;
+            }
+            OsError("WaitForMultipleObjects", nullptr);
+            isRunning = false;
+            return;
+        }
+    }
+
+    bool connect() {
+        if (ConnectNamedPipe(pipe, &overlapped) != FALSE) {
+            return true;
+        }
+        auto err = GetLastError();
+        if (err == ERROR_IO_PENDING) {
+            return true;
+        }
+        if (err == ERROR_PIPE_CONNECTED) {
+            SetEvent(overlapped.hEvent);
+            return true;
+        }
+        OsError("ConnectNamedPipe", nullptr);
+        return false;
+    }
+
+    void respond() {
+        CHAR  request[PIPE_BUFFER_SIZE + 1];
+        DWORD read{};
+        Reply reply{};
+        ++requests;
+        if (complete(ReadFile(pipe, request, PIPE_BUFFER_SIZE, &read, &overlapped), read) && read > 0) {
+            request[read] = '\0';
+            output.isClientaTerminal = request[0] != 0;
+            output.isBroken = false;
+            List<const CHAR*> args{};
+            args.append("exc"); // What {Configuration::parseOptions} skips.
+            for (auto arg = request + 1; arg < request + read; arg += cstrlen(arg) + 1) {
+                args.append(arg);
+            }
+            if (args.length > 1 && String{ args.items[1] } == String{ S("--stop") }) {
+                isRunning = false;
+            } else {
+                compile(reply, args.length, args.items); // '--compile', or options alone.
+            }
+            if (!output.send(Frame::Reply, &reply, sizeof(reply))) {
+                OsError("WriteFile", nullptr);
+            }
+            FlushFileBuffers(pipe);
+            args.dispose();
+        } else {
+            OsError("ReadFile", nullptr);
+        }
+        if (DisconnectNamedPipe(pipe) == FALSE) {
+            OsError("DisconnectNamedPipe", nullptr);
+        }
+    }
+
+    bool complete(BOOL ok, DWORD &bytes) {
+        if (ok == FALSE && GetLastError() != ERROR_IO_PENDING) {
+            return false;
+        }
+        return GetOverlappedResult(pipe, &overlapped, &bytes, TRUE) != FALSE;
+    }
+
+    void compile(Reply &reply, INT requestArgc, const CHAR **requestArgv) {
+        auto  start = microseconds();
+        auto &config = compiler.config;
+        config.resetOptions();
+        config.parseOptions(argc, argv, true);
+        config.parseOptions(requestArgc, requestArgv, true);
+        auto console = redirectConsoleFormatStream(&output);
+        compiler.errors = 0;
+        compiler.disposeTypedTree();
+        if (compiler.sourceTree == nullptr || watcher.isStale || config.lazyFunctionBodies != isLazy) {
+            compiler.disposeTrees();
+            isLazy = config.lazyFunctionBodies;
+        } else if (watcher.refresh() > 0 && compiler.errors == 0) {
+            compiler.syntaxTree->refresh();
+        }
+        if (watcher.isStale) {
+            compiler.disposeTrees(); // Went stale partway through {refresh}: the trees are half updated.
+        }
+        auto isCold = compiler.sourceTree == nullptr;
+        if (compiler.errors == 0 && compiler.build()) {
+            if (isCold) {
+                watcher.clear(); // The new tree was scanned after the changes noted so far.
+            }
+        } else {
+            compiler.disposeTrees(); // Rebuild everything on the next request.
+        }
+        compiler.summarizeErrors();
+        redirectConsoleFormatStream(console);
+        reply.errors  = compiler.errors;
+        reply.elapsed = microseconds() - start;
+        traceln("request %i#<green>: %i#<red> error%c in %i64#<green> µs", requests,
+                reply.errors, reply.errors == 1 ? "" : "s", reply.elapsed);
+    }
+};
+//----------------------------------------------------------
+namespace server {
+void run(INT argc, const CHAR **argv) {
+    Server server{ argc, argv };
+    if (server.initialize()) {
+        while (server.isRunning) {
+            server.serve();
+        }
+    }
+    server.dispose();
+}
+
+INT forward(INT argc, const CHAR **argv) {
+    String request{};
+    request.append(isConsoleaTerminal() ? "\1" : "\0", 1);
+    for (auto i = 0; i < argc; i++) {
+        request.append(argv[i], cstrlen(argv[i])).append(S("\0"));
+    }
+    if (argc == 0) {
+        request.append(S("--compile\0"));
+    }
+    if (request.length > PIPE_BUFFER_SIZE) {
+        traceln("the command line is longer than the %i#<red> bytes a request can take", PIPE_BUFFER_SIZE);
+        request.dispose();
+        return -1;
+    }
+    auto pipe = INVALID_HANDLE_VALUE;
+    while (true) {
+        pipe = CreateFile(PIPE_NAME, GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+        if (pipe != INVALID_HANDLE_VALUE) {
+            break;
+        }
+        if (GetLastError() != ERROR_PIPE_BUSY || WaitNamedPipe(PIPE_NAME, NMPWAIT_WAIT_FOREVER) == FALSE) {
+            traceln("no compile server is listening on %c#<yellow>", PIPE_NAME);
+            request.dispose();
+            return -1;
+        }
+    }
+    DWORD mode = PIPE_READMODE_MESSAGE;
+    if (SetNamedPipeHandleState(pipe, &mode, nullptr, nullptr) == FALSE) {
+        OsError("SetNamedPipeHandleState", nullptr);
+    }
+    auto   start = microseconds();
+    DWORD written{};
+    DWORD    read{};
+    Reply   reply{ -1 };
+    CHAR  message[PIPE_BUFFER_SIZE];
+    if (WriteFile(pipe, request.text, request.length, &written, nullptr) == FALSE) {
+        OsError("WriteFile", nullptr);
+    } else {
+        // The server's output while compiling, then its reply.
+        while (ReadFile(pipe, message, sizeof(message), &read, nullptr) != FALSE && read > 0 &&
+               Frame(message[0]) == Frame::Text) {
+            getConsoleFormatStream()->write(message + 1, INT(read) - 1);
+        }
+        if (read == 1 + sizeof(reply) && Frame(message[0]) == Frame::Reply) {
+            MemCopy(&reply, message + 1);
+            auto elapsed = microseconds() - start;
+            traceln("%i#<red> error%c, %i64#<green> µs compiling, %i64#<green> µs round-trip",
+                    reply.errors, reply.errors == 1 ? "" : "s", reply.elapsed, elapsed);
+        } else {
+            OsError("ReadFile", nullptr);
+        }
+    }
+    CloseHandle(pipe);
+    request.dispose();
+    return reply.errors;
+}
+
+// Compares a cold build, which pays for the identifier table, the source
+// folder scan and every tree, against {runs} warm rebuilds of the typed tree.
+INT bench(INT runs) {
+    auto start = microseconds();
+    ids.initialize();
+    if (compiler.config.initialize()) {
+        compiler.build();
+    }
+    auto cold = microseconds() - start;
+    INT64 best = MAXINT64;
+    INT64 total{};
+    auto  warm = 0;
+    for (; warm < runs && compiler.errors == 0; ++warm) {
+        start = microseconds();
+        compiler.disposeTypedTree();
+        compiler.build();
+        auto elapsed = microseconds() - start;
+        best = min(best, elapsed);
+        total += elapsed;
+    }
+    auto errors = compiler.errors;
+    traceln("cold: %i64#<green> µs", cold);
+    if (warm > 0) {
+        traceln("warm: %i64#<green> µs best, %i64#<green> µs mean over %i#<green> run%c",
+                best, total / warm, warm, warm == 1 ? "" : "s");
+    }
+    compiler.dispose();
+    return errors;
+}
+} // namespace server
+} // namespace exy
\ No newline at end of file
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace exy {
+namespace server {
+void run(INT argc, const CHAR **argv); // The server's command line, which every request starts from.
+INT forward(INT argc, const CHAR **argv);
+INT bench(INT runs);
+} // namespace server
+} // namespace exy
\ No newline at end of file
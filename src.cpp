@@ -69,7 +69,10 @@ bool SourceTree::initialize() {
         visitSourceFolder(list.items[i]);
     }
     folders.compact();
-    tokenize();
+    List<SourceFile*> files{};
+    collect(files);
+    load(files);
+    files.dispose();
     if (compiler.errors == 0) {
         printTree();
     }
@@ -78,8 +81,18 @@ bool SourceTree::initialize() {
 }
 
 void SourceTree::dispose() {
-    folders.dispose([](auto x) { x->dispose(); });
-    mem.dispose();
+    folders.dispose([](auto x) { x->dispose(); MemFree(x); });
+}
+
+void SourceTree::load(List<SourceFile*> &files) {
+    {
+        stats::Timer timer{ stats::Phase::Read };
+        read(files);
+    }
+    {
+        stats::Timer timer{ stats::Phase::Tokenize };
+        tokenize(files);
+    }
 }
 
 void SourceTree::visitSourceFolder(Identifier folderPath) {
@@ -88,7 +101,7 @@ void SourceTree::visitSourceFolder(Identifier folderPath) {
             traceln("a source folder cannot be named %s#<red>: %s#<red>", folderName, folderPath);
             ++compiler.errors;
         } else {
-            auto folder = mem.New<SourceFolder>(nullptr, folderPath, folderName, folderName);
+            auto folder = MemNew<SourceFolder>(nullptr, folderPath, folderName, folderName);
             folders.append(folder);
             folder->initialize();
         }
@@ -107,7 +120,7 @@ void SourceTree::printFolder(SourceFolder *folder, INT indent) {
     traceln("%s#<yellow>", folder->name);
     for (auto i = 0; i < folder->files.length; i++) {
         for (auto j = 0; j < indent + 1; j++) trace("  ");
-        auto &file = folder->files.items[i];
+        auto &file = *folder->files.items[i];
         traceln("%s#<yellow underline> (%i#<darkyellow> B, %i#<darkyellow> characte%c, %i#<darkyellow> lin%c, %i#<darkyellow> toke%c)", file.name, 
                 file.source.length,
                 file.characters, file.characters == 1 ? "r" : "rs",
@@ -139,29 +152,67 @@ void SourceTree::printTokens(SourceFile &file, INT indent) {
     }
 }
 
-void SourceTree::tokenize() {
-    for (auto i = 0; i < folders.length; i++) {
-        tokenize(folders.items[i]);
+// Tokenizes one {SourceFile} per call on the aio threads.
+struct SourceTokenizer {
+    void dispose() {}
+
+    void run(SourceFile *file) {
+        stats::Event event{ "Tokenizer", "tokenize", file->dotName };
+        Tokenizer lexer{ *file };
+        lexer.run();
+    }
+};
+
+void SourceTree::tokenize(List<SourceFile*> &files) {
+    SourceTokenizer tokenizer{};
+    aio::run(tokenizer, files);
+    tokenizer.dispose();
+    if (stats::format != stats::Format::None) {
+        stats::count(stats::Counter::Files, files.length);
+        for (auto i = 0; i < files.length; i++) {
+            stats::count(stats::Counter::Bytes, files.items[i]->source.length);
+            stats::count(stats::Counter::Tokens, files.items[i]->tokens.length);
+        }
     }
 }
 
-void SourceTree::tokenize(SourceFolder *folder) {
-    for (auto i = 0; i < folder->folders.length; i++) {
-        tokenize(folder->folders.items[i]);
+// Reads every source file with one batch of overlapped reads instead of a ReadFile call per file.
+void SourceTree::read(List<SourceFile*> &files) {
+    List<SourceFile*> opened{};
+    List<aio::Read>   reads{};
+    for (auto i = 0; i < files.length; i++) {
+        auto file = files.items[i];
+        aio::Read r{};
+        if (file->open(r)) {
+            opened.append(file);
+            reads.append(r);
+        }
     }
-    for (auto i = 0; i < folder->files.length; i++) {
-        tokenize(folder->files.items[i]);
+    if (reads.isNotEmpty()) {
+        aio::read(reads);
+        for (auto i = 0; i < opened.length; i++) {
+            opened.items[i]->close(reads.items[i]);
+        }
+    }
+    reads.dispose();
+    opened.dispose();
+}
+
+void SourceTree::collect(List<SourceFile*> &files) {
+    for (auto i = 0; i < folders.length; i++) {
+        collect(folders.items[i], files);
     }
 }
 
-void SourceTree::tokenize(SourceFile &file) {
-    Tokenizer lexer{ file };
-    lexer.run();
+void SourceTree::collect(SourceFolder *folder, List<SourceFile*> &files) {
+    for (auto i = 0; i < folder->folders.length; i++) {
+        collect(folder->folders.items[i], files);
+    }
+    files.append(folder->files);
 }
 //----------------------------------------------------------
 void SourceFolder::initialize() {
     const String extension{ S(EXY_EXTENSION) };
-    auto &mem = compiler.sourceTree->mem;
     WIN32_FIND_DATA wfd{};
     String tmp{};
     tmp.append(path).append(S("\\*"));
@@ -177,23 +228,12 @@ void SourceFolder::initialize() {
             } else if ((wfd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0) {
                 String subFolderPath{};
                 subFolderPath.append(path).append(S("\\")).append(itemName);
-                if (compiler.config.subFolderHasAtLeastOneSourceFile(subFolderPath)) {
-                    auto   subFolderPathId = ids.get(subFolderPath);
-                    if (auto subFolderName = getNameFromPath(subFolderPathId, /* isaFile = */ false)) {
-                        auto     subFolder = mem.New<SourceFolder>(this, subFolderPathId, subFolderName, makeDotName(this, subFolderName));
-                        folders.append(subFolder);
-                        subFolder->initialize();
-                    }
-                }
+                addFolder(subFolderPath);
                 subFolderPath.dispose();
             } else if (itemName.endsWith(extension)) {
                 String filePath{};
                 filePath.append(path).append(S("\\")).append(itemName);
-                auto   filePathId = ids.get(filePath);
-                if (auto fileName = getNameFromPath(filePathId, /* isaFile = */ true)) {
-                    auto    &file = files.place(this, filePathId, fileName, makeDotName(this, fileName));
-                    file.initialize();
-                }
+                addFile(filePath); // Read by {SourceTree::read}.
                 filePath.dispose();
             }
         } while (FindNextFile(handle, &wfd) != FALSE);
@@ -209,59 +249,100 @@ void SourceFolder::initialize() {
 }
 
 void SourceFolder::dispose() {
-    folders.dispose([](auto x) { x->dispose(); });
-    files.dispose([](auto &x) { x.dispose(); });
+    folders.dispose([](auto x) { x->dispose(); MemFree(x); });
+    files.dispose([](auto x) { x->dispose(); MemFree(x); });
+}
+
+SourceFolder* SourceFolder::addFolder(const String &subFolderPath) {
+    if (!Configuration::subFolderHasAtLeastOneSourceFile(subFolderPath)) {
+        return nullptr;
+    }
+    auto subFolderPathId = ids.get(subFolderPath);
+    auto   subFolderName = getNameFromPath(subFolderPathId, /* isaFile = */ false);
+    if (subFolderName == nullptr) {
+        return nullptr;
+    }
+    auto subFolder = MemNew<SourceFolder>(this, subFolderPathId, subFolderName, makeDotName(this, subFolderName));
+    folders.append(subFolder);
+    subFolder->initialize();
+    return subFolder;
+}
+
+SourceFile* SourceFolder::addFile(const String &filePath) {
+    auto filePathId = ids.get(filePath);
+    auto   fileName = getNameFromPath(filePathId, /* isaFile = */ true);
+    if (fileName == nullptr) {
+        return nullptr;
+    }
+    return files.append(MemNew<SourceFile>(this, filePathId, fileName, makeDotName(this, fileName)));
 }
 
 SourceFile& SourceFolder::posFile() {
     for (auto i = 0; i < files.length; i++) {
-        auto &file = files.items[i];
+        auto &file = *files.items[i];
         if (file.name == ids.kw_main) {
             return file;
         }
     }
     for (auto i = 0; i < files.length; i++) {
-        auto &file = files.items[i];
+        auto &file = *files.items[i];
         if (file.name == name) {
             return file;
         }
     }
-    return files.first();
+    return *files.first();
 }
 //----------------------------------------------------------
 #define MAX_FILE_SIZE 0x10000
+// Reads {this} file on its own; {SourceTree::read} reads a batch of files the same way.
 void SourceFile::initialize() {
-    auto handle = CreateFile(path->text, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
-                             FILE_ATTRIBUTE_NORMAL, nullptr);
-    if (handle == INVALID_HANDLE_VALUE) {
-        OsError("FindFirstFile", nullptr);
+    aio::Read r{};
+    if (open(r)) {
+        aio::os::read(&r, 1);
+        close(r);
+    }
+}
+
+// Opens {this} file and prepares {r} to read all of it into {source}. Returns false if there is
+// nothing to read, either because {this} file is empty or because of an error.
+bool SourceFile::open(aio::Read &r) {
+    INT64 size{};
+    auto file = aio::os::openForRead(path->text, size);
+    if (file == aio::os::invalidFile) {
+        OsError("CreateFile", nullptr);
+        ++compiler.errors;
+        return false;
+    }
+    if (size > MAX_FILE_SIZE) {
+        traceln("file too large: %s#<yellow> %i64#<red> B", path, size);
         ++compiler.errors;
+    } else if (size == 0) {
+        source.reserve(1);
     } else {
-        LARGE_INTEGER li{};
-        if (GetFileSizeEx(handle, &li) == FALSE) {
-            OsError("GetFileSizeEx", nullptr);
-            ++compiler.errors;
-        } else if (li.QuadPart > MAX_FILE_SIZE) {
-            traceln("file too large: %s#<yellow> %i64#<red> B", path, li.QuadPart);
-            ++compiler.errors;
-        } else if (li.QuadPart == 0) {
-            source.reserve(1);
-        } else {
-            DWORD b{};
-            source.reserve(INT(li.QuadPart));
-            if (ReadFile(handle, source.text, INT(li.QuadPart), &b, nullptr) == FALSE) {
-                OsError("ReadFile", nullptr);
-                ++compiler.errors;
-            } else {
-                source.length = INT(li.QuadPart);
-            }
-        }
-        CloseHandle(handle);
+        source.reserve(INT(size));
+        r.file   = file;
+        r.buffer = source.text;
+        r.length = INT(size);
+        return true;
+    }
+    aio::os::closeFile(file);
+    return false;
+}
+
+void SourceFile::close(aio::Read &r) {
+    if (r.error != 0 || r.transferred != r.length) {
+        OsError("ReadFile", nullptr);
+        ++compiler.errors;
+    } else {
+        source.length = r.length;
     }
+    aio::os::closeFile(r.file);
 }
 
 void SourceFile::dispose() {
     tokens.dispose();
+    enclosures.dispose();
+    lineStarts.dispose();
     source.dispose();
 }
 
@@ -270,4 +351,17 @@ SourceToken SourceFile::pos() const {
     auto  &last = tokens.last();
     return SourceToken(*this, first.pos.range.start, last.pos.range.end, Tok::Unknown);
 }
+
+String SourceFile::lineAt(INT line) const {
+    Check(line >= 1 && line <= lineStarts.length);
+    auto start = source.start() + lineStarts.items[line - 1];
+    auto   end = line < lineStarts.length ? source.start() + lineStarts.items[line] : source.end();
+    if (end > start && end[-1] == '\n') {
+        --end;
+    }
+    if (end > start && end[-1] == '\r') {
+        --end;
+    }
+    return String{ start, end };
+}
 } // namespace exy
\ No newline at end of file
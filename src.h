@@ -4,23 +4,28 @@ namespace exy {
 struct SourceTree;
 struct SourceFolder;
 struct SourceFile;
+struct SyntaxFolder;
+struct SyntaxFile;
 //----------------------------------------------------------
+// Folders and files are allocated one by one so that a resident server can add and remove them.
 struct SourceTree {
-    Mem                 mem;
     List<SourceFolder*> folders;
 
     bool initialize();
     void dispose();
 
+    void load(List<SourceFile*>&); // Reads and tokenizes {files}.
+    static void collect(SourceFolder*, List<SourceFile*>&);
+
 private:
     void visitSourceFolder(Identifier);
     void printTree();
     void printFolder(SourceFolder*, INT indent);
     void printTokens(SourceFile&, INT indent);
 
-    void tokenize();
-    void tokenize(SourceFolder*);
-    void tokenize(SourceFile&);
+    void read(List<SourceFile*>&);
+    void tokenize(List<SourceFile*>&);
+    void collect(List<SourceFile*>&);
 };
 //----------------------------------------------------------
 struct SourceFolder {
@@ -28,8 +33,9 @@ struct SourceFolder {
     Identifier          path;
     Identifier          name;
     Identifier          dotName;
-    List<SourceFile>    files;
+    List<SourceFile*>   files;
     List<SourceFolder*> folders;
+    SyntaxFolder       *syntax{}; // Set once {this} folder is in the syntax tree.
 
     SourceFolder(SourceFolder *parent, Identifier path, Identifier name, Identifier dotName) :
         parent(parent), path(path), name(name), dotName(dotName) {}
@@ -37,11 +43,16 @@ struct SourceFolder {
     void initialize();
     void dispose();
 
+    SourceFolder* addFolder(const String &path); // Scans the sub-folder at {path}; null if it holds no source file.
+    SourceFile*   addFile(const String &path);   // Null if the name at the end of {path} is not valid.
+
     SourceFile& posFile();
 };
 //----------------------------------------------------------
 struct SourceFile {
     List<SourceToken> tokens;
+    Dict<INT>         enclosures;   // Index of each closing token by index of its opening token plus 1.
+    List<INT>         lineStarts;   // Offset in {source} of the first character of each line; set by the {Tokenizer}.
     String            source;
     SourceFolder     *parent;
     Identifier        path;
@@ -49,6 +60,7 @@ struct SourceFile {
     Identifier        dotName;
     INT               lines{};
     INT               characters{};
+    SyntaxFile       *syntax{};     // Set once {this} file is parsed.
 
     SourceFile(SourceFolder *parent, Identifier path, Identifier name, Identifier dotName) :
         parent(parent), path(path), name(name), dotName(dotName) {}
@@ -56,7 +68,42 @@ struct SourceFile {
     void initialize();
     void dispose();
 
+    bool open(aio::Read&);
+    void close(aio::Read&);
+
     SourceToken pos() const;
+    String lineAt(INT line) const; // The text of 1-based {line}, without its line break.
+};
+//----------------------------------------------------------
+// Watches the top-level source folders for changes and applies them to the source and syntax
+// trees in place: modified files are re-read and re-tokenized, and added, removed or renamed files
+// and folders are added to or removed from their parent folders. Only a lost notification, or a
+// top-level folder going away, makes the whole source tree stale.
+struct SourceWatcher {
+    struct Watch;
+    struct Change;
+    List<Watch*>        watches;
+    List<Change>        changes; // Noted by {notify} in order; applied by {refresh}.
+    List<SourceFolder*> added;   // New folders, for the syntax tree.
+    List<SourceFile*>   changed; // To re-read and re-tokenize in {refresh}: modified or new.
+    bool                isStale; // Changes were lost: the source tree must be rebuilt.
+
+    bool initialize();
+    void dispose();
+
+    void clear(); // Forgets the changes noted so far, once the source tree is rebuilt.
+    HANDLE event(INT) const;
+    void notify(INT);
+    INT refresh();
+
+private:
+    void notify(Watch*, FILE_NOTIFY_INFORMATION*);
+    void apply(Change&);
+    void add(SourceFolder *parent, const String &path);
+    void add(SourceFolder*);
+    void remove(SourceFile*);
+    void remove(SourceFolder*);
+    void forget(SourceFolder*);
 };
 //----------------------------------------------------------
 } // namespace exy
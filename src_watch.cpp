@@ -0,0 +1,334 @@
+#include "pch.h"
+#include <stringapiset.h>
+#include "src.h"
+
+#include "tokenizer.h"
+#include "syntax.h"
+
+#define WATCH_BUFFER_SIZE 0x4000
+
+namespace exy {
+struct SourceWatcher::Watch {
+    OVERLAPPED    overlapped;
+    HANDLE        handle;
+    Identifier    path;     // Path of the watched top-level folder.
+    DWORD         buffer[WATCH_BUFFER_SIZE / sizeof(DWORD)]; // DWORD-aligned as required.
+
+    bool read() {
+        const auto filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE;
+        if (ReadDirectoryChangesW(handle, buffer, sizeof(buffer), TRUE, filter, nullptr, &overlapped, nullptr) == FALSE) {
+            OsError("ReadDirectoryChangesW", nullptr);
+            return false;
+        }
+        return true;
+    }
+};
+
+struct SourceWatcher::Change {
+    DWORD  action; // FILE_ACTION_*.
+    String path;   // Full path of the file or folder.
+};
+//----------------------------------------------------------
+bool SourceWatcher::initialize() {
+    auto &list = compiler.config.sourceFolders;
+    for (auto i = 0; i < list.length; i++) {
+        if (watches.length == MAXIMUM_WAIT_OBJECTS - 1) {
+            traceln("too many source folders to watch: %s#<yellow> is not watched", list.items[i]);
+            continue;
+        }
+        auto path = list.items[i];
+        auto handle = CreateFile(path->text, FILE_LIST_DIRECTORY,
+                                 FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                 OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            OsError("CreateFile", nullptr);
+            ++compiler.errors;
+            continue;
+        }
+        auto watch = MemAlloc<Watch>();
+        MemZero(watch);
+        watch->handle = handle;
+        watch->path = path;
+        watch->overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+        watches.append(watch);
+        if (watch->overlapped.hEvent == nullptr) {
+            OsError("CreateEvent", nullptr);
+            ++compiler.errors;
+        } else if (!watch->read()) {
+            ++compiler.errors;
+        }
+    }
+    return compiler.errors == 0;
+}
+
+void SourceWatcher::dispose() {
+    watches.dispose([](Watch *watch) {
+        CancelIoEx(watch->handle, &watch->overlapped);
+        CloseHandle(watch->handle);
+        if (watch->overlapped.hEvent != nullptr) {
+            CloseHandle(watch->overlapped.hEvent);
+        }
+        MemFree(watch);
+    });
+    changes.dispose([](Change &change) { change.path.dispose(); });
+    added.dispose();
+    changed.dispose();
+}
+
+void SourceWatcher::clear() {
+    changes.clear([](Change &change) { change.path.dispose(); });
+    added.clear();
+    changed.clear();
+    isStale = false;
+}
+
+HANDLE SourceWatcher::event(INT index) const {
+    return watches.items[index]->overlapped.hEvent;
+}
+
+// Notes the notifications of the signaled watch at {index} for {refresh}.
+void SourceWatcher::notify(INT index) {
+    auto watch = watches.items[index];
+    DWORD bytes{};
+    if (GetOverlappedResult(watch->handle, &watch->overlapped, &bytes, FALSE) == FALSE) {
+        OsError("GetOverlappedResult", nullptr);
+        isStale = true;
+    } else if (bytes == 0) {
+        isStale = true; // The buffer overflowed; the changes are unknown.
+    } else {
+        auto pos = (BYTE*)watch->buffer;
+        while (true) {
+            auto info = (FILE_NOTIFY_INFORMATION*)pos;
+            notify(watch, info);
+            if (info->NextEntryOffset == 0) {
+                break;
+            }
+            pos += info->NextEntryOffset;
+        }
+    }
+    ResetEvent(watch->overlapped.hEvent);
+    watch->read();
+}
+
+void SourceWatcher::notify(Watch *watch, FILE_NOTIFY_INFORMATION *info) {
+    auto len = WideCharToMultiByte(CP_ACP, 0, info->FileName, info->FileNameLength / sizeof(WCHAR),
+                                   tmpbuf, tmpbufcap, nullptr, nullptr);
+    if (len <= 0) {
+        isStale = true;
+        return;
+    }
+    Change change{ info->Action };
+    change.path.append(watch->path).append(S("\\")).append(tmpbuf, len);
+    changes.append(change);
+}
+//----------------------------------------------------------
+// Paths compare as the file system does: case-insensitively.
+static bool isSame(Identifier path, const String &other) {
+    return path->length == other.length && String{ other.text, other.length }.cmp(*path, false) == 0;
+}
+
+static bool isWithin(Identifier folder, const String &path) {
+    return path.length > folder->length && path.text[folder->length] == '\\' &&
+           String{ path.text, folder->length }.cmp(*folder, false) == 0;
+}
+
+// The deepest known folder holding {path}, or null if {path} is outside every top-level folder.
+static SourceFolder* findParent(List<SourceFolder*> &folders, const String &path) {
+    for (auto i = 0; i < folders.length; i++) {
+        auto folder = folders.items[i];
+        if (isWithin(folder->path, path)) {
+            auto found = findParent(folder->folders, path);
+            return found == nullptr ? folder : found;
+        }
+    }
+    return nullptr;
+}
+
+static SourceFile* findFile(SourceFolder *parent, const String &path) {
+    for (auto i = 0; i < parent->files.length; i++) {
+        if (isSame(parent->files.items[i]->path, path)) {
+            return parent->files.items[i];
+        }
+    }
+    return nullptr;
+}
+
+static SourceFolder* findFolder(SourceFolder *parent, const String &path) {
+    for (auto i = 0; i < parent->folders.length; i++) {
+        if (isSame(parent->folders.items[i]->path, path)) {
+            return parent->folders.items[i];
+        }
+    }
+    return nullptr;
+}
+
+// Whether {path} ends in a name directly under {folder}.
+static bool isaChildOf(SourceFolder *folder, const String &path) {
+    for (auto i = folder->path->length + 1; i < path.length; i++) {
+        if (path.text[i] == '\\') {
+            return false;
+        }
+    }
+    return true;
+}
+//----------------------------------------------------------
+// Applies the noted changes to the source tree in order, re-reads and re-tokenizes the modified
+// and added files, and hands every change on to the syntax tree for {SyntaxTree::refresh}.
+// Returns the number of changes applied, or 0 if the tree is stale: a change that goes stale
+// leaves the ones before it applied, so the caller must then build from scratch.
+INT SourceWatcher::refresh() {
+    auto count = changes.length;
+    if (count == 0 || isStale) {
+        return 0;
+    }
+    for (auto i = 0; i < changes.length && !isStale; i++) {
+        apply(changes.items[i]);
+    }
+    changes.clear([](Change &change) { change.path.dispose(); });
+    if (isStale) {
+        added.clear();
+        changed.clear();
+        return 0;
+    }
+    auto &syntaxTree = *compiler.syntaxTree;
+    for (auto i = 0; i < changed.length; i++) {
+        auto file = changed.items[i];
+        traceln("refreshing %s#<yellow>", file->path);
+        file->dispose();
+        file->lines = file->characters = 0;
+    }
+    kws.initialize();
+    compiler.sourceTree->load(changed);
+    kws.dispose();
+    if (compiler.errors == 0) {
+        for (auto i = 0; i < added.length; i++) {
+            auto folder = added.items[i];
+            if (folder->syntax == nullptr) { // Else added with its parent.
+                syntaxTree.add(*folder);
+            }
+        }
+        for (auto i = 0; i < changed.length; i++) {
+            auto file = changed.items[i];
+            if (file->syntax != nullptr) {
+                syntaxTree.invalidate(*file);
+            } else if (file->parent->syntax != nullptr) {
+                syntaxTree.add(*file);
+            }
+        }
+    }
+    added.clear();
+    changed.clear();
+    return count;
+}
+
+void SourceWatcher::apply(Change &change) {
+    auto parent = findParent(compiler.sourceTree->folders, change.path);
+    if (parent == nullptr) {
+        return; // Not in a top-level folder in the tree.
+    }
+    switch (change.action) {
+        case FILE_ACTION_MODIFIED: {
+            auto file = findFile(parent, change.path);
+            if (file != nullptr && !changed.contains(file)) {
+                changed.append(file);
+            } // else a folder or a non-source file was modified.
+        } break;
+        case FILE_ACTION_REMOVED:
+        case FILE_ACTION_RENAMED_OLD_NAME: {
+            if (auto file = findFile(parent, change.path)) {
+                remove(file);
+            } else if (auto folder = findFolder(parent, change.path)) {
+                remove(folder);
+            }
+        } break;
+        case FILE_ACTION_ADDED:
+        case FILE_ACTION_RENAMED_NEW_NAME: {
+            add(parent, change.path);
+        } break;
+    }
+}
+
+// Adds the folder or the source file at {path} to {parent}, the deepest folder in the tree holding it.
+void SourceWatcher::add(SourceFolder *parent, const String &path) {
+    const String extension{ S(EXY_EXTENSION) };
+    if (findFile(parent, path) != nullptr || findFolder(parent, path) != nullptr) {
+        return; // Scanned with its folder.
+    }
+    auto attributes = GetFileAttributes(path.text);
+    if (attributes == INVALID_FILE_ATTRIBUTES) {
+        return; // Gone again.
+    }
+    if ((attributes & FILE_ATTRIBUTE_DIRECTORY) != 0) {
+        if (isaChildOf(parent, path)) {
+            add(parent->addFolder(path));
+        } // else it is added with the first source file in it.
+        return;
+    }
+    if (!path.endsWith(extension)) {
+        return;
+    }
+    if (isaChildOf(parent, path)) {
+        if (auto file = parent->addFile(path)) {
+            changed.append(file);
+        }
+        return;
+    }
+    // In a folder left out of the tree until now for holding no source file.
+    auto at = path.length - 1;
+    while (path.text[at] != '\\') {
+        at--;
+    }
+    String folderPath{};
+    folderPath.append(path.text, at);
+    if (isaChildOf(parent, folderPath)) {
+        add(parent->addFolder(folderPath));
+    } else {
+        isStale = true; // Several new levels of folders: rebuild.
+    }
+    folderPath.dispose();
+}
+
+void SourceWatcher::add(SourceFolder *folder) {
+    if (folder != nullptr) {
+        added.append(folder);
+        SourceTree::collect(folder, changed);
+    }
+}
+
+// A folder holds at least one source file, so removing the last one removes the folder.
+void SourceWatcher::remove(SourceFile *file) {
+    auto folder = file->parent;
+    if (folder->files.length == 1) {
+        remove(folder);
+        return;
+    }
+    compiler.syntaxTree->remove(*file);
+    folder->files.remove(file);
+    changed.remove(file);
+    file->dispose();
+    MemFree(file);
+}
+
+void SourceWatcher::remove(SourceFolder *folder) {
+    if (folder->parent == nullptr) {
+        isStale = true; // A top-level folder: the modules may have lost their main file.
+        return;
+    }
+    compiler.syntaxTree->remove(*folder);
+    folder->parent->folders.remove(folder);
+    forget(folder);
+    folder->dispose();
+    MemFree(folder);
+}
+
+// Drops {folder} and everything in it from {added} and {changed}, before it is disposed.
+void SourceWatcher::forget(SourceFolder *folder) {
+    added.remove(folder);
+    for (auto i = 0; i < folder->folders.length; i++) {
+        forget(folder->folders.items[i]);
+    }
+    for (auto i = 0; i < folder->files.length; i++) {
+        changed.remove(folder->files.items[i]);
+    }
+}
+} // namespace exy
\ No newline at end of file
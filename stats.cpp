@@ -0,0 +1,267 @@
+#include "pch.h"
+
+#include "src.h"
+#include "syntax.h"
+#include "tp.h"
+
+namespace exy {
+namespace stats {
+#define DeclareStatsArenas(ZM) \
+    ZM(Identifiers)            \
+    ZM(SyntaxTree)             \
+    ZM(TpTree)
+
+enum class Arena {
+#define ZM(zName) zName,
+    DeclareStatsArenas(ZM)
+#undef ZM
+    Count
+};
+
+static SRWLOCK       srw{};
+static List<Thread*> threads{};
+static volatile LONG64 phases[INT(Phase::Count)]{};
+static INT64         arenas[INT(Arena::Count)]{};
+static thread_local Thread *current = nullptr;
+
+Thread* thread() {
+    if (current == nullptr) {
+        current = MemAlloc<Thread>();
+        current->id = GetCurrentThreadId();
+        AcquireSRWLockExclusive(&srw);
+        threads.append(current);
+        ReleaseSRWLockExclusive(&srw);
+    }
+    return current;
+}
+
+INT64 microseconds() {
+    static LARGE_INTEGER frequency{};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter{};
+    QueryPerformanceCounter(&counter);
+    auto seconds = counter.QuadPart / frequency.QuadPart;
+    auto    rest = counter.QuadPart % frequency.QuadPart;
+    return seconds * 1000000 + rest * 1000000 / frequency.QuadPart;
+}
+
+Timer::~Timer() {
+    if (format != Format::None) {
+        InterlockedAdd64(&phases[INT(phase)], microseconds() - start);
+    }
+}
+
+BusyTimer::~BusyTimer() {
+    if (format != Format::None) {
+        thread()->busy += microseconds() - start;
+    }
+}
+
+Event::~Event() {
+    if (eventsPath == nullptr) {
+        return;
+    }
+    auto t = thread();
+    if (t->events == nullptr) {
+        t->events = MemAlloc<EventRecord>(INT(Thread::capacity));
+    }
+    auto &record = t->events[t->length++ & (Thread::capacity - 1)];
+    record.start    = start;
+    record.duration = microseconds() - start;
+    record.category = category;
+    record.name     = name;
+    auto length = 0;
+    if (detail != nullptr) {
+        length = min(detail->length, INT(_countof(record.detail)) - 1);
+        MemCopy(record.detail, detail->text, length);
+    }
+    record.detail[length] = '\0';
+}
+
+void sampleArenas() {
+    if (format == Format::None) {
+        return;
+    }
+    arenas[INT(Arena::Identifiers)] = ids.mem.size();
+    if (compiler.syntaxTree != nullptr) {
+        arenas[INT(Arena::SyntaxTree)] = compiler.syntaxTree->size();
+    }
+    if (compiler.tpTree != nullptr) {
+        arenas[INT(Arena::TpTree)] = compiler.tpTree->mem.size();
+    }
+}
+
+static const CHAR *const phaseNames[] = {
+#define ZM(zName, zDepth) #zName,
+    DeclareStatsPhases(ZM)
+#undef ZM
+};
+static const INT phaseDepths[] = {
+#define ZM(zName, zDepth) zDepth,
+    DeclareStatsPhases(ZM)
+#undef ZM
+};
+static const CHAR *const counterNames[] = {
+#define ZM(zName) #zName,
+    DeclareStatsCounters(ZM)
+#undef ZM
+};
+static const CHAR *const arenaNames[] = {
+#define ZM(zName) #zName,
+    DeclareStatsArenas(ZM)
+#undef ZM
+};
+
+static void reportTable(const INT64 (&totals)[INT(Counter::Count)], const heap::Usage &usage) {
+    traceln("Phases:");
+    for (auto i = 0; i < INT(Phase::Count); i++) {
+        trace("  ");
+        for (auto j = 0; j < phaseDepths[i]; j++) {
+            trace("  ");
+        }
+        traceln("%c#<cyan> %i64#<green> µs", phaseNames[i], INT64(phases[i]));
+    }
+    traceln("Counters:");
+    for (auto i = 0; i < INT(Counter::Count); i++) {
+        traceln("  %c#<cyan> %i64#<green>", counterNames[i], totals[i]);
+    }
+    traceln("Heap:");
+    traceln("  allocs %u64#<green>, reallocs %u64#<green>, frees %u64#<green>, peak %u64#<green> B",
+            usage.allocs, usage.reallocs, usage.frees, usage.maxUsed);
+    traceln("Arenas:");
+    for (auto i = 0; i < INT(Arena::Count); i++) {
+        traceln("  %c#<cyan> %i64#<green> B", arenaNames[i], arenas[i]);
+    }
+    traceln("Threads:");
+    for (auto i = 0; i < threads.length; i++) {
+        auto t = threads.items[i];
+        traceln("  thread(%u#<green>#0x) %i64#<green> task%c, %i64#<green> µs busy", UINT(t->id),
+                t->counters[INT(Counter::AioTasks)], t->counters[INT(Counter::AioTasks)] == 1 ? "" : "s",
+                t->busy);
+    }
+}
+
+static void reportJson(const INT64 (&totals)[INT(Counter::Count)], const heap::Usage &usage) {
+    trace("{\"phases\":{");
+    for (auto i = 0; i < INT(Phase::Count); i++) {
+        trace("%c\"%c\":%i64", i ? "," : "", phaseNames[i], INT64(phases[i]));
+    }
+    trace("},\"counters\":{");
+    for (auto i = 0; i < INT(Counter::Count); i++) {
+        trace("%c\"%c\":%i64", i ? "," : "", counterNames[i], totals[i]);
+    }
+    trace("},\"heap\":{\"allocs\":%u64,\"reallocs\":%u64,\"frees\":%u64,\"peak\":%u64}",
+          usage.allocs, usage.reallocs, usage.frees, usage.maxUsed);
+    trace(",\"arenas\":{");
+    for (auto i = 0; i < INT(Arena::Count); i++) {
+        trace("%c\"%c\":%i64", i ? "," : "", arenaNames[i], arenas[i]);
+    }
+    trace("},\"threads\":[");
+    for (auto i = 0; i < threads.length; i++) {
+        auto t = threads.items[i];
+        trace("%c{\"id\":%u,\"tasks\":%i64,\"busy\":%i64}", i ? "," : "", UINT(t->id),
+              t->counters[INT(Counter::AioTasks)], t->busy);
+    }
+    traceln("]}");
+}
+
+static void sum(INT64 (&totals)[INT(Counter::Count)]) {
+    AcquireSRWLockShared(&srw);
+    for (auto i = 0; i < threads.length; i++) {
+        for (auto j = 0; j < INT(Counter::Count); j++) {
+            totals[j] += threads.items[i]->counters[j];
+        }
+    }
+    ReleaseSRWLockShared(&srw);
+}
+
+static void forget() {
+    AcquireSRWLockShared(&srw);
+    for (auto i = 0; i < threads.length; i++) {
+        auto t = threads.items[i];
+        MemZero(t->counters, INT(Counter::Count));
+        t->busy = 0;
+    }
+    ReleaseSRWLockShared(&srw);
+    for (auto i = 0; i < INT(Phase::Count); i++) {
+        phases[i] = 0;
+    }
+    MemZero(arenas, INT(Arena::Count));
+}
+
+void snapshot(Snapshot &out) {
+    MemZero(out.counters, INT(Counter::Count));
+    sum(out.counters);
+    for (auto i = 0; i < INT(Phase::Count); i++) {
+        out.phases[i] = phases[i];
+    }
+    forget();
+}
+
+void report() {
+    if (format == Format::None) {
+        return;
+    }
+    INT64 totals[INT(Counter::Count)]{};
+    auto usage = heap::usage();
+    sum(totals);
+    AcquireSRWLockShared(&srw);
+    if (format == Format::Json) {
+        reportJson(totals, usage);
+    } else {
+        reportTable(totals, usage);
+    }
+    ReleaseSRWLockShared(&srw);
+    forget();
+}
+
+void writeEvents() {
+    if (eventsPath == nullptr) {
+        return;
+    }
+    auto handle = CreateFile(eventsPath, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        traceln("cannot write trace events to %c#<red>", eventsPath);
+        return;
+    }
+    FileFormatSink       sink{ handle };
+    BufferedFormatStream stream{ &sink };
+    stream.lock(); // Flushed a buffer at a time rather than a line at a time.
+    print(&stream, "{\"traceEvents\":[");
+    auto separator = "";
+    AcquireSRWLockShared(&srw);
+    for (auto i = 0; i < threads.length; i++) {
+        auto t = threads.items[i];
+        if (t->events == nullptr) {
+            continue;
+        }
+        auto first = max(t->length - Thread::capacity, 0ll);
+        for (auto j = first; j < t->length; j++) {
+            auto &record = t->events[j & (Thread::capacity - 1)];
+            print(&stream, "%c\r\n{\"pid\":1,\"tid\":%u,\"ph\":\"X\",\"cat\":\"%c\",\"name\":\"%c%c%c\",\"ts\":%i64,\"dur\":%i64}",
+                  separator, UINT(t->id), record.category, record.name, record.detail[0] ? " " : "",
+                  record.detail, record.start, record.duration);
+            separator = ",";
+        }
+        t->events = MemFree(t->events);
+        t->length = 0;
+    }
+    ReleaseSRWLockShared(&srw);
+    print(&stream, "\r\n]}\r\n");
+    stream.unlock();
+    CloseHandle(handle);
+    traceln("trace events written to %c#<yellow>", eventsPath);
+}
+
+void dispose() {
+    // The pool threads have exited: nothing counts any more.
+    threads.dispose([](auto x) {
+        MemFree(x->events);
+        MemFree(x);
+    });
+    current = nullptr;
+}
+} // namespace stats
+} // namespace exy
\ No newline at end of file
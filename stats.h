@@ -0,0 +1,123 @@
+#pragma once
+
+namespace exy {
+namespace stats {
+// name, depth in the report
+#define DeclareStatsPhases(ZM) \
+    ZM(Configure, 0)           \
+    ZM(Sources,   0)           \
+    ZM(Read,      1)           \
+    ZM(Tokenize,  1)           \
+    ZM(Syntax,    0)           \
+    ZM(Parse,     1)           \
+    ZM(Modules,   1)           \
+    ZM(Types,     0)           \
+    ZM(Builtins,  1)           \
+    ZM(Bind,      1)           \
+    ZM(Teardown,  0)
+
+#define DeclareStatsCounters(ZM) \
+    ZM(Files)                    \
+    ZM(Bytes)                    \
+    ZM(Tokens)                   \
+    ZM(SyntaxNodes)              \
+    ZM(TpNodes)                  \
+    ZM(Symbols)                  \
+    ZM(TemplateInstances)        \
+    ZM(Casts)                    \
+    ZM(AioTasks)
+
+enum class Phase {
+#define ZM(zName, zDepth) zName,
+    DeclareStatsPhases(ZM)
+#undef ZM
+    Count
+};
+
+enum class Counter {
+#define ZM(zName) zName,
+    DeclareStatsCounters(ZM)
+#undef ZM
+    Count
+};
+
+enum class Format {
+    None,  // No '--stats'.
+    Table, // '--stats'
+    Json   // '--stats=json'
+};
+inline Format format = Format::None;
+
+inline const CHAR *eventsPath = nullptr; // '--trace-events <path>': where {writeEvents} writes.
+
+struct EventRecord {
+    INT64       start, duration; // Microseconds.
+    const CHAR *category;
+    const CHAR *name;
+    CHAR        detail[48];      // Copied: what it names may be disposed before {writeEvents}.
+};
+
+// What one thread counted. Each thread only writes its own, so counting takes no lock.
+struct Thread {
+    static constexpr INT64 capacity = 0x4000; // Of {events}: the oldest are overwritten.
+
+    DWORD        id;
+    INT64        counters[INT(Counter::Count)];
+    INT64        busy;   // Microseconds spent running aio tasks.
+    EventRecord *events; // Allocated by the first {Event} when {eventsPath} is set.
+    INT64        length; // Of all the events recorded; those before {length - capacity} were overwritten.
+};
+Thread* thread(); // Registers the calling thread the first time.
+
+inline void count(Counter counter, INT64 n = 1) {
+    if (format != Format::None) {
+        thread()->counters[INT(counter)] += n;
+    }
+}
+
+INT64 microseconds();
+
+// Adds the time from its construction to its destruction to {phase}.
+struct Timer {
+    Phase phase;
+    INT64 start;
+
+    Timer(Phase phase) : phase(phase), start(format != Format::None ? microseconds() : 0) {}
+    ~Timer();
+};
+
+// Adds the time from its construction to its destruction to the calling thread's {Thread::busy}.
+struct BusyTimer {
+    INT64 start;
+
+    BusyTimer() : start(format != Format::None ? microseconds() : 0) {}
+    ~BusyTimer();
+};
+
+/*  A scope shown as one bar on the Chrome trace timeline ('chrome://tracing', Perfetto) of the calling
+*   thread, e.g. { "Typer", "bind module", moduleName }. Costs one branch unless {eventsPath} is set.
+*/
+struct Event {
+    const CHAR *category;
+    const CHAR *name;
+    Identifier  detail;
+    INT64       start;
+
+    Event(const CHAR *category, const CHAR *name, Identifier detail = nullptr)
+        : category(category), name(name), detail(detail), start(eventsPath != nullptr ? microseconds() : 0) {}
+    ~Event();
+};
+
+// What was recorded between two calls of {snapshot}, e.g. one repetition of a benchmark.
+struct Snapshot {
+    INT64 phases[INT(Phase::Count)]; // Microseconds.
+    INT64 counters[INT(Counter::Count)];
+};
+
+void sampleArenas(); // Records the size of each tree's {Mem} before the trees are disposed.
+void snapshot(Snapshot &out); // Copies what was recorded into {out}, then forgets it.
+void report();       // Prints what was recorded as {format} says, then forgets it.
+void writeEvents();  // Writes every thread's {Event}s to {eventsPath} as Chrome trace JSON.
+void dispose();
+} // namespace stats
+} // namespace exy
\ No newline at end of file
@@ -10,16 +10,165 @@ namespace exy {
 using Pos = const SourceToken&;
 
 bool SyntaxTree::initialize() {
-    parse(nullptr, compiler.sourceTree->folders);
+    {
+        stats::Timer timer{ stats::Phase::Parse };
+        parse(nullptr, compiler.sourceTree->folders);
+        parseFiles();
+    }
     if (compiler.errors == 0) {
+        stats::Timer timer{ stats::Phase::Modules };
+        discoverModules();
+    }
+    return compiler.errors == 0;
+}
+
+static void reposition(SyntaxModule *mod) {
+    auto file = mod->main != nullptr ? mod->main : mod->init != nullptr ? mod->init : mod->files.first();
+    mod->pos = file->src.pos();
+    for (auto i = 0; i < mod->modules.length; i++) {
+        reposition(mod->modules.items[i]);
+    }
+}
+
+// Parses the files {invalidate} and {add} queued, and re-seats what pointed into the old tokens.
+// The modules are discovered again only when files came or went or a module statement changed;
+// otherwise they stay as they were, and only their positions are refreshed.
+bool SyntaxTree::refresh() {
+    const auto reparsed = unparsed.isNotEmpty();
+    {
+        stats::Timer timer{ stats::Phase::Parse };
+        parseFiles();
+    }
+    for (auto i = 0; i < moved.length; i++) {
+        moved.items[i]->reposition();
+    }
+    moved.clear();
+    if (compiler.errors != 0) {
+        return false;
+    }
+    if (isReshaped) {
+        stats::Timer timer{ stats::Phase::Modules };
+        modules.dispose([](auto x) { x->dispose(); MemFree(x); });
         discoverModules();
+    } else if (reparsed) {
+        for (auto i = 0; i < modules.length; i++) {
+            reposition(modules.items[i]);
+        }
     }
     return compiler.errors == 0;
 }
+
+// Parses {fn}'s skipped body once. Threads binding instances of the same template at the same
+// time wait for the first one to finish parsing it.
+void SyntaxTree::parseLazyBody(FunctionSyntax *fn) {
+    if (!fn->isLazy || !fn->lazyParse.begin()) {
+        return;
+    }
+    auto file = fn->pos.pos.file.syntax;
+    Parser parser{ *file };
+    parser.parseLazyBody(fn);
+    parser.dispose();
+    fn->lazyParse.finish();
+    fn->isLazy = false; // After {finish}, so that a binder that sees it cleared also sees the parsed body.
+}
+
 void SyntaxTree::dispose() {
-    ldispose(folders);
-    ldispose(modules);
-    mem.dispose();
+    folders.dispose([](auto x) { x->dispose(); MemFree(x); });
+    modules.dispose([](auto x) { x->dispose(); MemFree(x); });
+    unparsed.dispose();
+    moved.dispose();
+    dotNames.dispose();
+}
+
+static INT64 sizeOf(SyntaxFolder *folder) {
+    INT64 size = 0;
+    for (auto i = 0; i < folder->folders.length; i++) {
+        size += sizeOf(folder->folders.items[i]);
+    }
+    for (auto i = 0; i < folder->files.length; i++) {
+        size += folder->files.items[i]->mem.size();
+    }
+    return size;
+}
+
+INT64 SyntaxTree::size() {
+    INT64 size = 0;
+    for (auto i = 0; i < folders.length; i++) {
+        size += sizeOf(folders.items[i]);
+    }
+    return size;
+}
+
+void SyntaxTree::add(SourceFolder &srcFolder) {
+    auto parent = srcFolder.parent == nullptr ? nullptr : srcFolder.parent->syntax;
+    parse(parent, &srcFolder);
+    isReshaped = true;
+}
+
+void SyntaxTree::add(SourceFile &srcFile) {
+    auto parent = srcFile.parent->syntax;
+    parse(parent, srcFile);
+    if (!moved.contains(parent)) {
+        moved.append(parent);
+    }
+    isReshaped = true;
+}
+
+// Before {srcFolder} is disposed; the modules are discovered again, so none points to it after.
+void SyntaxTree::remove(SourceFolder &srcFolder) {
+    auto folder = srcFolder.syntax;
+    if (folder == nullptr) {
+        return;
+    }
+    if (folder->parent == nullptr) {
+        folders.remove(folder);
+    } else {
+        folder->parent->folders.remove(folder);
+    }
+    forget(folder);
+    folder->dispose();
+    MemFree(folder);
+    isReshaped = true;
+}
+
+void SyntaxTree::remove(SourceFile &srcFile) {
+    auto file = srcFile.syntax;
+    if (file == nullptr) {
+        return;
+    }
+    file->parent->files.remove(file);
+    if (!moved.contains(file->parent)) {
+        moved.append(file->parent);
+    }
+    unparsed.remove(file);
+    file->dispose();
+    MemFree(file);
+    isReshaped = true;
+}
+
+void SyntaxTree::invalidate(SourceFile &srcFile) {
+    auto file = srcFile.syntax;
+    if (file == nullptr || unparsed.contains(file)) {
+        return;
+    }
+    file->reset();
+    unparsed.append(file);
+    for (auto folder = file->parent; folder != nullptr; folder = folder->parent) {
+        if (&folder->src.posFile() == &srcFile && !moved.contains(folder)) {
+            moved.append(folder);
+        }
+    }
+}
+
+// Drops {folder} and everything in it from the queues, before it is disposed.
+void SyntaxTree::forget(SyntaxFolder *folder) {
+    moved.remove(folder);
+    for (auto i = 0; i < folder->folders.length; i++) {
+        forget(folder->folders.items[i]);
+    }
+    for (auto i = 0; i < folder->files.length; i++) {
+        unparsed.remove(folder->files.items[i]);
+    }
 }
 
 void SyntaxTree::parse(SyntaxFolder *parent, List<SourceFolder*>& list) {
@@ -28,14 +177,15 @@ void SyntaxTree::parse(SyntaxFolder *parent, List<SourceFolder*>& list) {
     }
 }
 
-void SyntaxTree::parse(SyntaxFolder *parent, List<SourceFile>& list) {
+void SyntaxTree::parse(SyntaxFolder *parent, List<SourceFile*>& list) {
     for (auto i = 0; i < list.length; i++) {
-        parse(parent, list.items[i]);
+        parse(parent, *list.items[i]);
     }
 }
 
 void SyntaxTree::parse(SyntaxFolder *parent, SourceFolder *srcFolder) {
-    auto folder = mem.New<SyntaxFolder>(*srcFolder, parent);
+    auto folder = MemNew<SyntaxFolder>(*srcFolder, parent);
+    srcFolder->syntax = folder;
     if (parent == nullptr) {
         folders.append(folder);
     } else {
@@ -46,37 +196,103 @@ void SyntaxTree::parse(SyntaxFolder *parent, SourceFolder *srcFolder) {
 }
 
 void SyntaxTree::parse(SyntaxFolder *parent, SourceFile &srcFile) {
-    auto file = mem.New<SyntaxFile>(srcFile, parent);
+    auto file = MemNew<SyntaxFile>(srcFile, parent);
+    srcFile.syntax = file;
     parent->files.append(file);
-    Parser parser{ *file };
-    parser.run();
+    unparsed.append(file);
+}
+
+// Parses one {SyntaxFile} per call on the aio threads.
+struct SyntaxParser {
+    void dispose() {}
+
+    void run(SyntaxFile *file) {
+        stats::Event event{ "Parser", "parse", file->src.dotName };
+        Parser parser{ *file };
+        parser.run();
+        parser.dispose();
+    }
+};
+
+static UINT moduleKeyOf(UINT key, SyntaxNode *name) {
+    if (name == nullptr) {
+        return key;
+    }
+    if (name->kind == SyntaxKind::Dot) {
+        auto dot = (DotSyntax*)name;
+        return moduleKeyOf(moduleKeyOf(key, dot->lhs), dot->rhs);
+    }
+    if (name->kind == SyntaxKind::Identifier) {
+        const UINT pair[2] = { key, ((IdentifierSyntax*)name)->value->hash };
+        return hash32(pair, sizeof(pair));
+    }
+    return key;
+}
+
+// Of the module statement's name and system: a file re-parsed to another key moves between modules.
+static UINT moduleKeyOf(SyntaxFile *file) {
+    auto node = file->moduleStatement;
+    if (node == nullptr) {
+        return 0;
+    }
+    auto key = moduleKeyOf(1, node->name);
+    return moduleKeyOf(key, node->system);
+}
+
+void SyntaxTree::parseFiles() {
+    SyntaxParser parser{};
+    aio::run(parser, unparsed);
     parser.dispose();
+    for (auto i = 0; i < unparsed.length; i++) {
+        auto file = unparsed.items[i];
+        auto  key = moduleKeyOf(file);
+        if (key != file->moduleKey) {
+            file->moduleKey = key;
+            isReshaped = true;
+        }
+    }
+    unparsed.clear();
 }
 //----------------------------------------------------------
+// {pos} refers to {first} rather than into {src}'s tokens, which are replaced when they are re-tokenized.
 SyntaxFolder::SyntaxFolder(SourceFolder &src, SyntaxFolder *parent) 
-    : SyntaxNode(src.posFile().tokens.first(), Kind::Folder), src(src), parent(parent) {}
+    : SyntaxNode(first, Kind::Folder), src(src), parent(parent), first(src.posFile().tokens.first()) {}
 
 void SyntaxFolder::dispose() {
-    ldispose(folders);
-    ldispose(files);
+    src.syntax = nullptr;
+    folders.dispose([](auto x) { x->dispose(); MemFree(x); });
+    files.dispose([](auto x) { x->dispose(); MemFree(x); });
     __super::dispose();
 }
 
 Pos SyntaxFolder::lastPos() const {
     return src.posFile().tokens.last();
 }
+
+void SyntaxFolder::reposition() {
+    first = src.posFile().tokens.first();
+}
 //----------------------------------------------------------
 SyntaxFile::SyntaxFile(SourceFile &src, SyntaxFolder *parent)
-    : SyntaxNode(src.tokens.first(), Kind::File), src(src), parent(parent) {}
+    : SyntaxNode(first, Kind::File), src(src), parent(parent), first(src.tokens.first()) {}
 
 void SyntaxFile::dispose() {
+    src.syntax = nullptr;
     ldispose(nodes);
+    mem.dispose();
     __super::dispose();
 }
 
 Pos SyntaxFile::lastPos() const {
     return src.tokens.last();
 }
+
+void SyntaxFile::reset() {
+    dispose(); // Leaves {nodes} and {mem} empty.
+    moduleStatement = nullptr;
+    first = src.tokens.first();
+    src.syntax = this;
+}
 //----------------------------------------------------------
 SyntaxModule::SyntaxModule(SyntaxFile *firstFile) : pos(firstFile->src.pos()) {}
 
@@ -84,7 +300,7 @@ SyntaxModule::SyntaxModule(SyntaxFile *main, SyntaxFile *init) :
     pos(main == nullptr ? init->src.pos() : main->src.pos()), main(main), init(init) {}
 
 void SyntaxModule::dispose() {
-    ldispose(modules);
+    modules.dispose([](auto x) { x->dispose(); MemFree(x); });
     files.dispose();
     main = init = nullptr;
 }
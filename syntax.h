@@ -86,18 +86,37 @@ enum class SyntaxKind {
 #undef ZM
 };
 //----------------------------------------------------------
+// Folders, files and modules are allocated one by one, and each file's nodes in the file's own arena,
+// so that a resident server can re-parse, add and remove files without the tree growing.
 struct SyntaxTree {
-    Mem                 mem;
     List<SyntaxFolder*> folders{};
     List<SyntaxModule*> modules{};
+    List<SyntaxFile*>   unparsed{};   // Files whose tokens are yet to be parsed, or to be parsed again.
+    List<SyntaxFolder*> moved{};      // Folders whose position file was re-tokenized, added or removed.
+    bool                isReshaped{}; // Files came or went, or changed module, since modules were discovered.
+    Dict<Identifier>    dotNames{};   // Of the modules by the hash of their parent's key and their name.
 
     bool initialize();
+    bool refresh();
     void dispose();
+    INT64 size(); // Bytes in the arenas of all the files.
+
+    // A resident server's changes to the source tree, made once the files involved are tokenized and
+    // applied by {refresh}.
+    void add(SourceFolder&);
+    void add(SourceFile&);
+    void remove(SourceFolder&);
+    void remove(SourceFile&);
+    void invalidate(SourceFile&); // Re-tokenized: parse it again.
+
+    void parseLazyBody(FunctionSyntax*);
 private:
+    void forget(SyntaxFolder*);
     void parse(SyntaxFolder *parent, List<SourceFolder*> &list);
-    void parse(SyntaxFolder *parent, List<SourceFile> &list);
+    void parse(SyntaxFolder *parent, List<SourceFile*> &list);
     void parse(SyntaxFolder *parent, SourceFolder *folder);
     void parse(SyntaxFolder *parent, SourceFile &file);
+    void parseFiles();
     // syntax_modules.cpp
     void discoverModules();
     void printModules();
@@ -118,7 +137,7 @@ struct SyntaxNode {
     Pos  pos;
     Kind kind;
 
-    SyntaxNode(Pos pos, Kind kind) : pos(pos), kind(kind) {}
+    SyntaxNode(Pos pos, Kind kind) : pos(pos), kind(kind) { stats::count(stats::Counter::SyntaxNodes); }
 
     virtual void dispose() {}
     virtual Pos lastPos() const { return pos; }
@@ -131,10 +150,12 @@ struct SyntaxFolder : SyntaxNode {
     List<SyntaxFile*>   files;  // All files in {this} folder.
     SyntaxFile         *main;   // The 1 and only {SyntaxFile} named 'main.exy' in {this} folder.
     SyntaxFile         *init;   // The 1 and only {SyntaxFile} with same name as {this} folder.
+    SourceToken         first;  // What {pos} refers to: the first token of {src}'s position file.
 
     SyntaxFolder(SourceFolder&, SyntaxFolder *parent);
     void dispose() override;
     Pos lastPos() const override;
+    void reposition(); // Refreshes {first} from {src}'s position file, which was re-tokenized, added or removed.
 };
 //----------------------------------------------------------
 struct SyntaxFile : SyntaxNode {
@@ -142,10 +163,14 @@ struct SyntaxFile : SyntaxNode {
     SyntaxFolder   *parent;          // The immediate parent {SyntaxFolder} of {this} file.
     ModuleSyntax   *moduleStatement; // The 1 and only file-scope level {ModuleSyntax} statement in {this} file. May be null.
     Nodes           nodes;           // All the statements in {this} file.
+    Mem             mem;             // Of the nodes in {this} file, lazily parsed bodies included.
+    UINT            moduleKey;       // Of {moduleStatement}'s name and system, or 0; see {SyntaxTree::refresh}.
+    SourceToken     first;           // What {pos} refers to: the first token of {src}.
 
     SyntaxFile(SourceFile&, SyntaxFolder *parent);
     void dispose() override;
     Pos lastPos() const override;
+    void reset(); // Disposes what {this} file was parsed to, once {src} is re-tokenized.
 };
 //----------------------------------------------------------
 struct SyntaxModule {
@@ -260,6 +285,8 @@ struct FunctionSyntax : SyntaxNode {
     OpPos bodyOp;
     Node  body;
     INT awaits, yields, returns;
+    bool  isLazy;     // {body} was skipped by the parser: an empty block stands for '{' ... '}' until {lazyParse} parses it.
+    Status lazyParse; // Of the skipped body, by the first thread to bind {this} function.
 
     FunctionSyntax(Node modifiers, Pos pos);
     void dispose() override;
@@ -11,52 +11,65 @@ using Path = List<Identifier>;
 struct Module {
     Module           *parent; // The immediate parent {Module} of {this} module.
     Identifier        name;   // Single string name of module.
+    UINT              key;    // Hash of the parent's {key} and {name}; identifies the fully-qualified name.
     Identifier        system; // Module output i.e. 'exe', 'dll' etc.
-    Dict<Module*>     modules;// All the child {Module}s of {this} module.
+    List<Module*>     modules;// All the child {Module}s of {this} module.
     List<SyntaxFile*> files;  // All the {SyntaxFile}s contributing to {this} module.
     SyntaxFile       *main;   // The 1 and only {SyntaxFile} named 'main.exy' in {this} module.
     SyntaxFile       *init;   // The 1 and only {SyntaxFile} with the same name as {this} module's term.
     SyntaxModule     *syntax;
 
-    Module(Module *parent, Identifier name) : parent(parent), name(name) {}
+    Module(Module *parent, Identifier name) : parent(parent), name(name),
+        key(parent == nullptr ? name->hash : keyOf(parent, name)) {}
 
     void dispose() {
         modules.dispose([](auto x) { x->dispose(); MemFree(x); });
         files.dispose();
     }
 
-    Module* contains(Identifier id) {
-        auto idx = modules.indexOf(id);
-        if (idx >= 0) {
-            return modules.items[idx].value;
-        }
-        return nullptr;
+    // The key of the child named {name} of {parent} without spelling out the dot-name.
+    static UINT keyOf(Module *parent, Identifier name) {
+        const UINT pair[2] = { parent->key, name->hash };
+        return hash32(pair, sizeof(pair));
     }
 };
 
 struct Visitor {
-    Module *root;
+    Module       *root;
+    Dict<Module*> index; // Every {Module} by {Module::key}.
 
     void initialize() {
         root = MemNew<Module>(nullptr, ids.kw_star);
     }
 
     void dispose() {
+        index.dispose();
         if (root != nullptr) {
             root->dispose();
             root = MemFree(root);
         }
     }
 
-    void visitFolder(Module *parent, SyntaxFolder *folder) {
-        auto   name = folder->src.name;
-        auto    idx = parent->modules.indexOf(name);
-        Module *mod = nullptr;
+    Module* find(Module *parent, Identifier name) {
+        auto idx = index.indexOf(Module::keyOf(parent, name));
         if (idx >= 0) {
-            mod = parent->modules.items[idx].value;
-        } else {
-            mod = parent->modules.append(name, MemNew<Module>(parent, name));
+            return index.items[idx].value;
         }
+        return nullptr;
+    }
+
+    Module* findOrAppend(Module *parent, Identifier name) {
+        if (auto found = find(parent, name)) {
+            return found;
+        }
+        auto mod = MemNew<Module>(parent, name);
+        parent->modules.append(mod);
+        index.append(mod->key, mod);
+        return mod;
+    }
+
+    void visitFolder(Module *parent, SyntaxFolder *folder) {
+        auto mod = findOrAppend(parent, folder->src.name);
         for (auto i = 0; i < folder->folders.length; i++) {
             visitFolder(mod, folder->folders.items[i]);
         }
@@ -77,41 +90,31 @@ struct Visitor {
         Path path{};
         getPathFromModuleName(path, file->moduleStatement->name);
         auto system = file->moduleStatement->system;
-        auto    mod = findOrAppendModule(parent, path, 0);
+        auto    mod = findOrAppendModule(parent, path);
         appendFile(mod, file, system);
         path.dispose();
     }
 
-    Module* findOrAppendModule(Module *parent, Path &path, INT j) {
-        const auto isFirst = j == 0;
-        if (isFirst) {
-            const auto name = path.first();
-            for (auto p = parent; p != nullptr; p = p->parent) {
-                if (p->name == name) {
-                    return findOrAppendModule(p, path, j + 1);
-                }
-                if (auto found = p->contains(name)) {
-                    return findOrAppendModule(found, path, j + 1);
-                }
+    // The first term of {path} binds to the nearest enclosing module named so, or to
+    // the nearest enclosing module with a child named so, or else to a new top-level
+    // module. Each following term is a child of the previous one.
+    Module* findOrAppendModule(Module *parent, Path &path) {
+        const auto name = path.first();
+        Module     *mod = nullptr;
+        for (auto p = parent; p != nullptr && mod == nullptr; p = p->parent) {
+            if (p->name == name) {
+                mod = p;
+            } else {
+                mod = find(p, name);
             }
-            auto mod = MemNew<Module>(root, name);
-            root->modules.append(name, mod);
-            return findOrAppendModule(mod, path, j + 1);
         }
-        const auto isLast = j == path.length;
-        if (isLast) {
-            return parent;
+        if (mod == nullptr) {
+            mod = findOrAppend(root, name);
         }
-        Assert(j < path.length);
-        const auto name = path.items[j];
-        const auto  idx = parent->modules.indexOf(name);
-        if (idx < 0) { // Not found.
-            auto mod = MemNew<Module>(parent, name);
-            parent->modules.append(name, mod);
-            return findOrAppendModule(mod, path, j + 1);
+        for (auto j = 1; j < path.length; j++) {
+            mod = findOrAppend(mod, path.items[j]);
         }
-        auto mod = parent->modules.items[idx].value;
-        return findOrAppendModule(mod, path, j + 1);
+        return mod;
     }
 
     void appendFile(Module *parent, SyntaxFile *file, IdentifierSyntax *system) {
@@ -152,32 +155,40 @@ struct Visitor {
     }
 };
 //----------------------------------------------------------
-static INT createSyntaxModules(String &dotName, Module *parent) {
-    auto mains = 0;
-    auto   eos = dotName.length;
-    if (dotName.isNotEmpty()) {
-        dotName.append(S("."));
+// Looked up by the module's {key}, so the dot-name is spelt out and hashed only the first time
+// a module is seen, not on every discovery after a refresh.
+static Identifier makeDotName(Module *parent, Module *mod) {
+    if (parent->syntax == nullptr) { // A top-level module.
+        return mod->name;
+    }
+    auto &dotNames = compiler.syntaxTree->dotNames;
+    auto idx = dotNames.indexOf(mod->key);
+    if (idx >= 0) {
+        return dotNames.items[idx].value;
     }
+    String text{};
+    text.append(parent->syntax->dotName).append(S(".")).append(mod->name);
+    auto dotName = ids.get(text);
+    text.dispose();
+    dotNames.append(mod->key, dotName);
+    return dotName;
+}
+
+static INT createSyntaxModules(Module *parent) {
+    auto mains = 0;
     auto &tree = *compiler.syntaxTree;
-    auto   eod = dotName.length;
-    auto  &mem = tree.mem;
     for (auto i = 0; i < parent->modules.length; i++) {
-        auto mod = parent->modules.items[i].value;
-        if (dotName.isNotEmpty()) {
-            dotName.text[dotName.length = eod] = '\0';
-        }
-        dotName.append(mod->name);
+        auto mod = parent->modules.items[i];
+        auto dotName = makeDotName(parent, mod);
         if (mod->files.isNotEmpty()) {
             SyntaxModule *node = nullptr;
             if (mod->main != nullptr || mod->init != nullptr) {
-                node = mem.New<SyntaxModule>(mod->main, mod->init);
+                node = MemNew<SyntaxModule>(mod->main, mod->init);
             } else {
-                node = mem.New<SyntaxModule>(mod->files.first());
-            }
-            for (auto j = 0; j < mod->files.length; j++) {
-                node->files.append(mod->files.items[j]);
+                node = MemNew<SyntaxModule>(mod->files.first());
             }
-            node->dotName = ids.get(dotName);
+            node->files.append(mod->files);
+            node->dotName = dotName;
             node->name    = mod->name;
             if (mod->system == nullptr) {
                 node->system = ids.kw_dll;
@@ -193,20 +204,17 @@ static INT createSyntaxModules(String &dotName, Module *parent) {
             if (mod->main != nullptr) {
                 ++mains;
             }
-            mains += createSyntaxModules(dotName, mod);
+            mains += createSyntaxModules(mod);
         } else {
             traceln("%c#<red>: folder %s#<yellow> is empty (all sub-folders and their files ignored)", "warning", dotName);
         }
     }
-    dotName.text[dotName.length = eos] = '\0';
     return mains;
 }
 
 static auto createSyntaxModules(Visitor &visitor) {
-    String dotName{};
     auto &tree = *compiler.syntaxTree;
-    auto mains = createSyntaxModules(dotName, visitor.root);
-    dotName.dispose();
+    auto mains = createSyntaxModules(visitor.root);
     if (mains == 0) {
         err(tree.modules.first()->pos, "no 'main' file in any module");
     }
@@ -214,6 +222,7 @@ static auto createSyntaxModules(Visitor &visitor) {
 //----------------------------------------------------------
 
 void SyntaxTree::discoverModules() {
+    isReshaped = false;
     Visitor visitor{};
     visitor.initialize();
     for (auto i = 0; i < folders.length; i++) {
@@ -6,7 +6,8 @@
 #define err(pos, msg, ...) diagnostic("Tokenizer", pos, msg, __VA_ARGS__)
 
 namespace exy {
-TokenProcessor::TokenProcessor(SourceFile &file) : tokens(file.tokens) {}
+TokenProcessor::TokenProcessor(SourceFile &file) : tokens(file.tokens), enclosures(file.enclosures),
+    isRecording(compiler.config.lazyFunctionBodies) {}
 
 void TokenProcessor::dispose() {
     opens.dispose();
@@ -82,7 +83,7 @@ void TokenProcessor::run() {
                 break; // Do nothing because "'", "w'" or "r'" inside '"' is meaningless.
             } else if (state == InSingleQuoted && pos.kind == Tok::SingleQuote) {
                 if (isNotEscaped) {
-                    opens.pop(); // Remove "'", "w'" or "r'", to go back to code.
+                    close(i); // Remove "'", "w'" or "r'", to go back to code.
                 }
             } else if (isInCode) {
                 opens.push(i); // Begin text inside "'", "w'" or "r'".
@@ -94,7 +95,7 @@ void TokenProcessor::run() {
                 break; // Do nothing because '"', 'w"' or 'r"' inside '"' is meaningless.
             } else if (state == InDoubleQuoted && pos.kind == Tok::DoubleQuote) {
                 if (isNotEscaped) {
-                    opens.pop(); // Remove '"', 'w"' or 'r"', to go back to code.
+                    close(i); // Remove '"', 'w"' or 'r"', to go back to code.
                 }
             } else if (isInCode) {
                 opens.push(i); // Begin text inside '"', 'w"' or 'r"'.
@@ -113,25 +114,25 @@ void TokenProcessor::run() {
             } break;
 
             case Tok::CloseParen: if (state == State::InParens) {
-                opens.pop(); // ')' in code with opening '(' or '#('. Pop state.
+                close(i); // ')' in code with opening '(' or '#('. Pop state.
             } else if (isInCode) {
                 err(pos, "unmatched %tok", &pos); // ')' in code without opening '(' or '#('.
             } break;
 
             case Tok::CloseBracket: if (state == State::InBrackets) {
-                opens.pop(); // ']' in code with opening '[' or '#['. Pop state.
+                close(i); // ']' in code with opening '[' or '#['. Pop state.
             } else if (isInCode) {
                 err(pos, "unmatched %tok", &pos); // ']' in code without opening '[' or '#['.
             } break;
 
             case Tok::CloseCurly: if (state == State::InCurlies) {
-                opens.pop(); // '}' in code with opening '{'. Pop state.
+                close(i); // '}' in code with opening '{'. Pop state.
             } else if (isInCode) {
                 err(pos, "unmatched %tok", &pos); // '}' in code without opening '{'.
             } break;
 
             case Tok::CloseCurlyHash: if (state == State::InHashCurlies) {
-                opens.pop(); // '}#' in text with opening '#{'. Pop state.
+                close(i); // '}#' in text with opening '#{'. Pop state.
             } else if (isInCode) {
                 err(pos, "unmatched %tok", &pos); // '}#' in code.
             } break;
@@ -255,6 +256,14 @@ TokenProcessor::State TokenProcessor::getState(Tok tok) {
     return InFile;
 }
 
+// Pops the enclosure closed at {i} and records the pair for {Parser::skipFunctionBody}.
+void TokenProcessor::close(INT i) {
+    auto open = opens.pop();
+    if (isRecording) {
+        enclosures.append(UINT(open + 1), i);
+    }
+}
+
 INT TokenProcessor::skipSingleLineComment(INT i) {
     // {i} is at '//' hence ++{i} as initializer.
     for (++i; i < tokens.length; ++i) {
@@ -5,6 +5,8 @@
 namespace exy {
 struct TokenProcessor {
     List<SourceToken> &tokens;
+    Dict<INT>         &enclosures;
+    const bool         isRecording; // Of {enclosures}: only '--lazy' looks them up.
 
     TokenProcessor(SourceFile &file);
     void dispose();
@@ -24,6 +26,7 @@ private:
         InDoubleQuoted, // text enclosed in '"' or 'w"' or 'r"'
     };
     State getState(Tok);
+    void close(INT i);
 
     INT skipSingleLineComment(INT i);
     INT skipMultiLineComment(INT i);
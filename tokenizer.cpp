@@ -8,25 +8,32 @@
 
 namespace exy {
 struct SourceCharReader {
+	const CHAR *start;
 	const CHAR *pos;
 	const CHAR *end;
+	List<INT>  &lineStarts;
 	INT         line = 1;
 	INT         col  = 1;
 
-	SourceCharReader(const String &source) : pos(source.start()), end(source.end()) {}
+	SourceCharReader(const String &source, List<INT> &lineStarts) : start(source.start()), pos(source.start()),
+		end(source.end()), lineStarts(lineStarts) {}
 
 	auto read() {
 		List<SourceChar> list{};
+		lineStarts.clear();
+		lineStarts.append(0);
 		for (; pos < end; pos++) {
 			if (*pos == '\r' && pos + 1 < end && pos[1] == '\n') {
 				list.place(pos, line, col);
 				++line;
 				col = 1;
 				++pos; // Now at LF. The {pos}++ above moves past '\n'.
+				lineStarts.append(INT(pos + 1 - start));
 			} else if (*pos == '\n') {
 				list.place(pos, line, col);
 				++line;
 				col = 1;
+				lineStarts.append(INT(pos + 1 - start));
 			} else {
 				list.place(pos, line, col);
 				movePos();
@@ -57,9 +64,11 @@ struct SourceCharStream {
 Tokenizer::Tokenizer(SourceFile &file) : file(file), tokens(file.tokens) {}
 
 void Tokenizer::run() {
-	SourceCharReader reader{ file.source };
+	SourceCharReader reader{ file.source, file.lineStarts };
 	auto src = reader.read();
 	file.lines = reader.line;
+	Assert(file.lines == file.lineStarts.length);
+	file.lineStarts.compact();
 	file.characters = src.length;
 	SourceCharStream stream{ file, src };
 	read(stream);
@@ -68,6 +77,8 @@ void Tokenizer::run() {
 	processor.run();
 	processor.dispose();
 	file.tokens.compact();
+	logln(Tokenizer, Debug, "tokenized %s#<cyan>: %i#<green> lines, %i#<green> tokens", file.dotName, file.lines,
+		  file.tokens.length);
 }
 
 INT Tokenizer::lengthOf(const CHAR src) {
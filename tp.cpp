@@ -8,10 +8,27 @@ TpType TpTree::tyVoidPointer{};
 DeclareBuiltinTypeKeywords(ZM)
 #undef ZM
 
+const TpType& TpTree::tyOf(Keyword keyword) {
+    static const TpType *const types[] = {
+    #define ZM(zName, zSize) &ty##zName,
+        DeclareBuiltinTypeKeywords(ZM)
+    #undef ZM
+    };
+    auto index = TpBuiltinTraits::indexOf(keyword);
+    Check(index >= 0 && index < _countof(types));
+    return *types[index];
+}
+
 bool TpTree::initialize() {
     scope = mem.New<TpScope>(/* parent = */ nullptr, /* owner = */ nullptr);
-    initializeBuiltins();
-    if (initializeModules()) {
+    auto ok = false;
+    {
+        stats::Timer timer{ stats::Phase::Builtins };
+        initializeBuiltins();
+        ok = initializeModules();
+    }
+    if (ok) {
+        stats::Timer timer{ stats::Phase::Bind };
         Typer tp{};
         tp.run();
         tp.dispose();
@@ -33,7 +50,7 @@ void TpTree::initializeBuiltins() {
         auto node = mem.New<TpBuiltin>(pos, Keyword::zName, name); \
         auto  sym = mem.New<TpSymbol>(nullptr, name, node); \
         node->type = sym; \
-        scope->symbols.append(sym->name, sym); \
+        scope->append(sym); \
         ty##zName = node->type; \
         sym->bindStatus.value = Status::Done; \
     } while (0);
@@ -53,7 +70,7 @@ bool TpTree::initializeModules() {
             auto  sym = mem.New<TpSymbol>(nullptr, name, node);
             node->type  = sym;
             node->scope = mem.New<TpScope>(/* parent = */ scope, /* owner = */ sym);
-            scope->symbols.append(name, sym);
+            scope->append(sym);
             modules.append(sym);
             initializeModule(node);
         }
@@ -74,7 +91,7 @@ void TpTree::initializeModule(TpModule *node) {
             auto   sym = mem.New<TpSymbol>(nullptr, name, child);
             child->type = sym;
             child->scope = mem.New<TpScope>(/* parent = */ sc, /* owner = */ sym);
-            sc->symbols.append(name, sym);
+            sc->append(sym);
             modules.append(sym);
             initializeModule(child);
         }
@@ -83,7 +100,9 @@ void TpTree::initializeModule(TpModule *node) {
 
 //----------------------------------------------------------
 TpSymbol::TpSymbol(ParentScope scope, Identifier name, TpSymbolNode *node)
-    : scope(scope), name(name), node(node) {}
+    : scope(scope), name(name), node(node) {
+    stats::count(stats::Counter::Symbols);
+}
 
 void TpSymbol::dispose() {
     node = ndispose(node);
@@ -98,8 +117,15 @@ void TpScope::dispose() {
     ldispose(statements);
 }
 
+INT TpScope::indexOf(Identifier name) {
+    if (mayContain(name)) {
+        return symbols.indexOf(name);
+    }
+    return -1;
+}
+
 TpSymbol* TpScope::contains(Identifier name) {
-    auto idx = symbols.indexOf(name);
+    auto idx = indexOf(name);
     if (idx >= 0) {
         return symbols.items[idx].value;
     }
@@ -108,12 +134,15 @@ TpSymbol* TpScope::contains(Identifier name) {
 
 TpSymbol* TpScope::append(TpSymbol *symbol) {
     symbols.append(symbol->name, symbol);
+    bloom |= bloomOf(symbol->name);
     return symbol;
 }
 
 //----------------------------------------------------------
 TpNode::TpNode(Pos pos, Type type, Kind kind) 
-    : pos(pos), type(type), kind(kind) {}
+    : pos(pos), type(type), kind(kind) {
+    stats::count(stats::Counter::TpNodes);
+}
 
 String TpNode::kindName() const {
     return kindName(kind);
@@ -153,112 +182,23 @@ TpBuiltin::TpBuiltin(Pos pos, Keyword keyword, Identifier dotName)
 }
 
 TpType TpPacking::packedType() const {
-    auto  &tree = typer->tree;
     auto symbol = type.isaBuiltin();
-    auto   node = (TpBuiltin*)symbol->node;
-    switch (node->keyword) {
-        case Keyword::Char:
-        case Keyword::Int8: switch (count) {
-            case 16: return tree.tyInt8x16;
-            case 32: return tree.tyInt8x32;
-            case 64: return tree.tyInt8x64;
-        } break;
-        case Keyword::Int16: switch (count) {
-            case  8: return tree.tyInt16x8;
-            case 16: return tree.tyInt16x16;
-            case 32: return tree.tyInt16x32;
-        } break;
-        case Keyword::Int32: switch (count) {
-            case  4: return tree.tyInt32x4;
-            case  8: return tree.tyInt32x8;
-            case 16: return tree.tyInt32x16;
-        } break;
-        case Keyword::Int64: switch (count) {
-            case 2: return tree.tyInt64x2;
-            case 4: return tree.tyInt64x4;
-            case 8: return tree.tyInt64x8;
-        } break;
-        case Keyword::Bool:
-        case Keyword::UInt8: switch (count) {
-            case 16: return tree.tyUInt8x16;
-            case 32: return tree.tyUInt8x32;
-            case 64: return tree.tyUInt8x64;
-        } break;
-        case Keyword::UInt16: switch (count) {
-            case  8: return tree.tyUInt16x8;
-            case 16: return tree.tyUInt16x16;
-            case 32: return tree.tyUInt16x32;
-        } break;
-        case Keyword::UInt32: switch (count) {
-            case  4: return tree.tyUInt32x4;
-            case  8: return tree.tyUInt32x8;
-            case 16: return tree.tyUInt32x16;
-        } break;
-        case Keyword::UInt64: switch (count) {
-            case 2: return tree.tyUInt64x2;
-            case 4: return tree.tyUInt64x4;
-            case 8: return tree.tyUInt64x8;
-        } break;
-        case Keyword::Float: switch (count) {
-            case  4: return tree.tyFloatx4;
-            case  8: return tree.tyFloatx8;
-            case 16: return tree.tyFloatx16;
-        } break;
-        case Keyword::Double: switch (count) {
-            case 2: return tree.tyDoublex2;
-            case 4: return tree.tyDoublex4;
-            case 8: return tree.tyDoublex8;
-        } break;
+    Assert(symbol != nullptr);
+    auto packed = TpBuiltinTraits::packedOf(((TpBuiltin*)symbol->node)->keyword, count);
+    if (packed != Keyword::Void) {
+        return TpTree::tyOf(packed);
     }
     Assert(0);
-    return tree.tyUnknown;
+    return TpTree::tyUnknown;
 }
 
 TpPacking TpBuiltin::packing() const {
-    auto &tree = typer->tree;
-    switch (keyword) {
-        case Keyword::Floatx4:  return { tree.tyFloat,  4 };
-        case Keyword::Floatx8:  return { tree.tyFloat,  8 };
-        case Keyword::Floatx16: return { tree.tyFloat, 16 };
-
-        case Keyword::Doublex2: return { tree.tyDouble, 2 };
-        case Keyword::Doublex4: return { tree.tyDouble, 4 };
-        case Keyword::Doublex8: return { tree.tyDouble, 8 };
-
-        case Keyword::Int8x16: return { tree.tyInt8, 16 };
-        case Keyword::Int8x32: return { tree.tyInt8, 32 };
-        case Keyword::Int8x64: return { tree.tyInt8, 64 };
-
-        case Keyword::UInt8x16: return { tree.tyUInt8, 16 };
-        case Keyword::UInt8x32: return { tree.tyUInt8, 32 };
-        case Keyword::UInt8x64: return { tree.tyUInt8, 64 };
-
-        case Keyword::Int16x8:  return { tree.tyInt16,  8 };
-        case Keyword::Int16x16: return { tree.tyInt16, 16 };
-        case Keyword::Int16x32: return { tree.tyInt16, 32 };
-
-        case Keyword::UInt16x8:  return { tree.tyUInt16,  8 };
-        case Keyword::UInt16x16: return { tree.tyUInt16, 16 };
-        case Keyword::UInt16x32: return { tree.tyUInt16, 32 };
-
-        case Keyword::Int32x4:  return { tree.tyInt32,  4 };
-        case Keyword::Int32x8:  return { tree.tyInt32,  8 };
-        case Keyword::Int32x16: return { tree.tyInt32, 16 };
-
-        case Keyword::UInt32x4:  return { tree.tyUInt32,  4 };
-        case Keyword::UInt32x8:  return { tree.tyUInt32,  8 };
-        case Keyword::UInt32x16: return { tree.tyUInt32, 16 };
-
-        case Keyword::Int64x2: return { tree.tyInt64, 2 };
-        case Keyword::Int64x4: return { tree.tyInt64, 4 };
-        case Keyword::Int64x8: return { tree.tyInt64, 8 };
-
-        case Keyword::UInt64x2: return { tree.tyUInt64, 26 };
-        case Keyword::UInt64x4: return { tree.tyUInt64, 4 };
-        case Keyword::UInt64x8: return { tree.tyUInt64, 8 };
+    const auto &traits = builtinTraits[TpBuiltinTraits::indexOf(keyword)];
+    if (traits.flags & TpBuiltinTraits::Packed) {
+        return { TpTree::tyOf(traits.lane), traits.lanes };
     }
     Assert(0);
-    return TpPacking{ tree.tyUnknown, 0 };
+    return TpPacking{ TpTree::tyUnknown, 0 };
 }
 
 //----------------------------------------------------------
@@ -276,14 +216,83 @@ TpOverloadSet::TpOverloadSet(TpSymbol *first)
     : TpTypeNode(((TpTemplate*)first->node)->pos, Kind::OverloadSet, ((TpTemplate*)first->node)->dotName) {
     auto firstTemplate = (TpTemplate*)first->node;
     firstTemplate->parentOv = this;
-    list.append(first);
+    append(first);
 }
 
 void TpOverloadSet::dispose() {
     ldispose(list);
+    byArguments[0].dispose();
+    byArguments[1].dispose();
     __super::dispose();
 }
 
+void TpOverloadSet::append(TpSymbol *templateSymbol) {
+    list.append(templateSymbol);
+    bucket();
+}
+
+/*  Past the last bucket, only templates with varargs take the arguments, and they all do: the last
+*   bucket takes more arguments than any template requires. Sets of more than 64 templates are not
+*   bucketed and are matched one template at a time.
+*/
+void TpOverloadSet::bucket() {
+    byArguments[0].clear();
+    byArguments[1].clear();
+    if (list.length > 64) {
+        return;
+    }
+    auto span = 0;
+    for (auto i = 0; i < list.length; i++) {
+        const auto &arity = ((TpTemplate*)list.items[i]->node)->arity;
+        span = max(span, arity.required + arity.defaults + 1);
+    }
+    for (auto hasReceiver = 0; hasReceiver < 2; hasReceiver++) {
+        auto &buckets = byArguments[hasReceiver];
+        for (auto arguments = 0; arguments <= span; arguments++) {
+            UINT64 bits = 0;
+            for (auto i = 0; i < list.length; i++) {
+                const auto &arity = ((TpTemplate*)list.items[i]->node)->arity;
+                auto n = arguments + (arity.hasThis && hasReceiver ? 1 : 0);
+                if (n >= arity.required && (arity.varags || n <= arity.required + arity.defaults)) {
+                    bits |= 1ull << i;
+                }
+            }
+            buckets.append(bits);
+        }
+    }
+}
+
+/*  Returns the index of the first template in {list} after {after} that takes {arguments} (not
+*   counting the receiver) and may have a parameter for each of the {names} bits; -1 if none does.
+*/
+INT TpOverloadSet::indexOf(INT arguments, bool hasReceiver, UINT64 names, INT after) {
+    auto &buckets = byArguments[hasReceiver ? 1 : 0];
+    if (buckets.isEmpty()) {
+        for (auto i = after + 1; i < list.length; i++) {
+            const auto &arity = ((TpTemplate*)list.items[i]->node)->arity;
+            auto n = arguments + (arity.hasThis && hasReceiver ? 1 : 0);
+            if (n >= arity.required && (arity.varags || n <= arity.required + arity.defaults) &&
+                (names & ~arity.names) == 0) {
+                return i;
+            }
+        }
+        return -1;
+    }
+    auto bits = buckets.items[min(arguments, buckets.length - 1)];
+    if (after >= 0) {
+        bits &= ~0ull << after << 1;
+    }
+    DWORD i{};
+    while (_BitScanForward64(&i, bits)) {
+        const auto &arity = ((TpTemplate*)list.items[i]->node)->arity;
+        if ((names & ~arity.names) == 0) {
+            return INT(i);
+        }
+        bits &= bits - 1;
+    }
+    return -1;
+}
+
 //----------------------------------------------------------
 TpTemplate::TpTemplate(StructureSyntax *syntax, const TpArity &arity, Identifier dotName)
     : TpTypeNode(typer->mkPos(syntax), Kind::Template, dotName), syntax(syntax), arity(arity) {}
@@ -293,6 +302,7 @@ TpTemplate::TpTemplate(FunctionSyntax *syntax, const TpArity &arity, Identifier
 
 void TpTemplate::dispose() {
     ldispose(instances);
+    selected.dispose();
     __super::dispose();
 }
 
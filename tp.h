@@ -140,12 +140,14 @@ enum class TpKind {
      Mem      mem;   // The 1 and only {Mem} allocator for {this} tree.
      TpScope *scope; // The root {TpScope} of {this} tree. Contains {TpModule}s, {TpBuiltin}s and 'urlhandler' {TpTemplate}s.
      List<TpSymbol*> modules; // All the {TpModule}s in {this} tree.
+     SRWLOCK  srw;   // Guards the {instances} and {selected} of every {TpTemplate} while binders instantiate them.
 
      static TpType tyUnknown;
      static TpType tyVoidPointer;
  #define ZM(zName, zSize) static TpType ty##zName;
      DeclareBuiltinTypeKeywords(ZM)
  #undef ZM
+     static const TpType& tyOf(Keyword builtin); // The {ty##zName} of a builtin type keyword.
 
      bool initialize();
      void dispose();
@@ -162,6 +164,7 @@ enum class TpKind {
      Identifier    name;
      TpSymbolNode *node;
      Status        bindStatus;
+     TpIndirectType *volatile indirect = nullptr; // The interned {TpIndirectType} whose pointee is {this}.
 
      TpSymbol(ParentScope scope, Identifier name, TpSymbolNode *node);
      void dispose();
@@ -172,10 +175,19 @@ enum class TpKind {
      TpSymbol        *owner;  // The actual owner {TpSymbol} of {this} scope.
      Dict<TpSymbol*> symbols; // All the {TpSymbols} declared in {this} scope.
      List<TpNode*>   statements;
+     UINT64          bloom{}; // 2 bits per name in {symbols}: a name with either bit clear is not in {this} scope.
 
      TpScope(TpScope *parent, TpSymbol *owner);
      void dispose();
 
+     static UINT64 bloomOf(Identifier name) {
+         return (1ull << (name->hash & 63)) | (1ull << ((name->hash >> 6) & 63));
+     }
+     bool mayContain(Identifier name) const {
+         auto bits = bloomOf(name);
+         return (bloom & bits) == bits;
+     }
+     INT indexOf(Identifier name);
      TpSymbol* contains(Identifier name);
      TpSymbol* append(TpSymbol*);
      template<typename T>
@@ -273,9 +285,15 @@ struct TpModule : TpTypeNode {
 
 struct TpOverloadSet : TpTypeNode {
     List<TpSymbol*> list;
+    List<UINT64>    byArguments[2]; // [hasReceiver][arguments]: bit {i} is set if {list.items[i]} takes that many arguments.
 
     TpOverloadSet(TpSymbol *first);
     void dispose() override;
+
+    void append(TpSymbol *templateSymbol);
+    INT indexOf(INT arguments, bool hasReceiver, UINT64 names, INT after = -1);
+private:
+    void bucket();
 };
 
 struct TpArity {
@@ -283,6 +301,7 @@ struct TpArity {
     INT defaults;
     bool varags;
     bool hasThis;
+    UINT64 names; // {TpScope::bloomOf} each parameter name: a named argument with either bit clear is not a parameter.
 
     auto isZero()    const { return required == 0 && defaults == 0 && !varags; }
     auto isNotZero() const { return required > 0 || defaults > 0 || varags; }
@@ -291,6 +310,7 @@ struct TpArity {
 struct TpTemplate : TpTypeNode {
 
     List<TpSymbol*> instances;
+    Dict<TpSymbol*, UINT64> selected; // {instances} by the signature of the arguments that selected them.
     TpOverloadSet  *parentOv;
     SyntaxNode     *syntax;
     Identifier      dllPath;
@@ -101,9 +101,123 @@ void tp_cast::dispose() {
     list.dispose();
 }
 
+//----------------------------------------------------------
+void tp_cast_steps::dispose() {
+    for (auto i = 0; i < length; i++) {
+        items[i].dispose();
+    }
+    length = 0;
+}
+
 //----------------------------------------------------------
 void tp_cast_list::dispose() {
-    casts.dispose([](auto &x) { x.dispose(); });
+    casts.dispose();
+}
+
+//----------------------------------------------------------
+static constexpr INT numberOfBuiltins = _countof(builtinTraits);
+
+static INT builtinIndexOf(const TpType &type) {
+    if (auto traits = type.builtinTraitsOf()) {
+        return TpBuiltinTraits::indexOf(traits->keyword);
+    }
+    return -1;
+}
+
+enum : LONG { PathEmpty, PathBusy, PathReady };
+
+void tp_cast_matrix::initialize() {
+    paths = MemAlloc<Path>(2 * numberOfBuiltins * numberOfBuiltins);
+}
+
+void tp_cast_matrix::dispose() {
+    paths = MemFree(paths);
+}
+
+tp_cast_matrix::Path* tp_cast_matrix::pathOf(const tp_cast_list &result) {
+    auto src = builtinIndexOf(result.src);
+    auto dst = builtinIndexOf(result.dst);
+    if (src < 0 || dst < 0) {
+        return nullptr;
+    }
+    return &paths[(INT(result.reason) * numberOfBuiltins + src) * numberOfBuiltins + dst];
+}
+
+// Fills in {result} if both types are builtins and their cast is known.
+bool tp_cast_matrix::find(tp_cast_list &result) {
+    auto path = pathOf(result);
+    if (path == nullptr || path->state != PathReady) {
+        return false;
+    }
+    result.ok = path->ok;
+    for (auto i = 0; i < path->length; i++) {
+        result.casts.place(TpTree::tyOf(builtinTraits[path->dsts[i]].keyword), tp_cast_kind(path->kinds[i]));
+    }
+    return true;
+}
+
+// The first binder to cast a pair fills its path in; others racing it are not held up.
+void tp_cast_matrix::remember(const tp_cast_list &result) {
+    auto path = pathOf(result);
+    if (path == nullptr || InterlockedCompareExchange(&path->state, PathBusy, PathEmpty) != PathEmpty) {
+        return;
+    }
+    for (auto i = 0; i < result.casts.length; i++) {
+        auto dst = builtinIndexOf(result.casts.items[i].dst);
+        if (dst < 0) {
+            InterlockedExchange(&path->state, PathEmpty); // Goes through a non-builtin: cannot be held.
+            return;
+        }
+        path->kinds[i] = UINT8(result.casts.items[i].kind);
+        path->dsts[i] = UINT8(dst);
+    }
+    path->ok = result.ok;
+    path->length = UINT8(result.casts.length);
+    InterlockedExchange(&path->state, PathReady);
+}
+
+//----------------------------------------------------------
+void tp_cast_cache::dispose() {
+    entries.dispose();
+}
+
+UINT64 tp_cast_cache::keyOf(const tp_cast_list &result) {
+    auto key = (result.src.identity() * 0x9E3779B97F4A7C15ull) ^ 
+               (result.dst.identity() * 0xC2B2AE3D27D4EB4Full) ^ UINT64(result.reason);
+    if (key == 0 || key == Dict<Entry, UINT64>::nullHash) {
+        key = 1;
+    }
+    return key;
+}
+
+bool tp_cast_cache::find(tp_cast_list &result) {
+    auto idx = entries.indexOf(keyOf(result));
+    if (idx < 0) {
+        return false;
+    }
+    const auto &entry = entries.items[idx].value;
+    if (entry.src != result.src || entry.dst != result.dst || entry.reason != result.reason) {
+        return false;
+    }
+    result.ok = entry.ok;
+    result.casts = entry.casts; // Memberwise {tp_cast::list}s are never remembered.
+    return true;
+}
+
+void tp_cast_cache::remember(const tp_cast_list &result) {
+    for (auto i = 0; i < result.casts.length; i++) {
+        if (result.casts.items[i].list.isNotEmpty()) {
+            return;
+        }
+    }
+    auto key = keyOf(result);
+    auto idx = entries.indexOf(key);
+    Entry entry{ result.src, result.dst, result.reason, result.ok, result.casts };
+    if (idx >= 0) {
+        entries.items[idx].value = entry; // Another pair with the same key.
+    } else {
+        entries.append(key, entry);
+    }
 }
 
 //----------------------------------------------------------
@@ -168,8 +282,32 @@ TpNode* Typer::cast(SyntaxNode *syntax, TpNode *value, const TpType &dst, tp_cas
     return node;
 }
 
+/*  Only a 'null' {value} can be cast differently from any other value of its type, so every other
+*   cast is looked up by type: in the builtin matrix shared by all binders or in this binder's cache.
+*/
 tp_cast_list Typer::canCast(TpNode *value, const TpType &dst, tp_cast_reason reason) {
+    stats::count(stats::Counter::Casts);
     const auto &src = value->type;
+    if (src == dst) {
+        return { src, dst, reason };
+    }
+    if (isa.Null(value)) {
+        return canCast(src, /* isNull = */ true, dst, reason);
+    }
+    tp_cast_list result{ src, dst, reason };
+    if (casts.find(result) || castCache.find(result)) {
+        return result;
+    }
+    auto computed = canCast(src, /* isNull = */ false, dst, reason);
+    if (src.isaBuiltin() && dst.isaBuiltin()) {
+        casts.remember(computed);
+    } else {
+        castCache.remember(computed);
+    }
+    return computed;
+}
+
+tp_cast_list Typer::canCast(const TpType &src, bool isNull, const TpType &dst, tp_cast_reason reason) {
     tp_cast_list result{ src, dst, reason };
     Caster cast{ result };
     const auto isImplicit = result.isImplicit();
@@ -181,7 +319,7 @@ tp_cast_list Typer::canCast(TpNode *value, const TpType &dst, tp_cast_reason rea
         return cast.fail();
     }
     //------------------------------------------------------
-    if (isa.Null(value)) {
+    if (isNull) {
         // Ok. implicit/explicit null → Any
         return cast.fromNull(dst).result;
     }
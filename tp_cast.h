@@ -5,13 +5,31 @@ struct tp_cast {
     List<tp_cast> list; // Memberwise casts if {kind} is MemberWise.
     TpType        dst;
     tp_cast_kind  kind;
+    tp_cast() : kind(tp_cast_kind::NoCast) {}
     tp_cast(Type dst, tp_cast_kind kind) : dst(dst), kind(kind) {}
     void dispose();
 };
 
+/* The steps of a cast, held in place: no cast takes more than {capacity} steps. */
+struct tp_cast_steps {
+    static constexpr INT capacity = 4;
+
+    tp_cast items[capacity];
+    INT     length = 0;
+
+    tp_cast& place(Type dst, tp_cast_kind kind) {
+        Check(length < capacity);
+        items[length] = tp_cast{ dst, kind };
+        return items[length++];
+    }
+    auto isEmpty()    const { return length == 0; }
+    auto isNotEmpty() const { return length != 0; }
+    void dispose();
+};
+
 struct tp_cast_list {
     Type &src, &dst;
-    List<tp_cast>  casts{};
+    tp_cast_steps  casts{};
     tp_cast_reason reason;
     bool          ok = true;
     tp_cast_list(Type &src, Type &dst, tp_cast_reason reason) : src(src), dst(dst), reason(reason) {}
@@ -19,4 +37,42 @@ struct tp_cast_list {
     auto failed() { return !ok; }
     auto isImplicit() { return reason == tp_cast_reason::ImplicitCast; }
 };
+
+/*  The cast from each builtin to each other builtin, for each reason. Sized from the builtin type
+*   keywords and filled in as pairs are first cast. Shared by all the {Typer}s like {TpIndirectTypes}.
+*/
+struct tp_cast_matrix {
+    struct Path {
+        volatile LONG state; // Empty, Busy (being filled in) or Ready.
+        bool          ok;
+        UINT8         length;
+        UINT8         kinds[tp_cast_steps::capacity];
+        UINT8         dsts[tp_cast_steps::capacity]; // Builtin indices.
+    };
+    Path *paths{}; // [reason][src][dst]
+
+    void initialize();
+    void dispose();
+    bool find(tp_cast_list &result);
+    void remember(const tp_cast_list &result);
+private:
+    Path* pathOf(const tp_cast_list &result);
+};
+
+/* The casts between types other than two builtins, remembered by one {Typer}. */
+struct tp_cast_cache {
+    struct Entry {
+        TpType         src, dst;
+        tp_cast_reason reason;
+        bool           ok;
+        tp_cast_steps  casts;
+    };
+    Dict<Entry, UINT64> entries{};
+
+    void dispose();
+    bool find(tp_cast_list &result);
+    void remember(const tp_cast_list &result);
+private:
+    static UINT64 keyOf(const tp_cast_list &result);
+};
 } // namespace exy
\ No newline at end of file
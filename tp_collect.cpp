@@ -36,12 +36,14 @@ static TpArity mkTemplateParameters(AngledSyntax *node) {
 	auto required = 0;
 	auto default_ = 0;
 	auto   varags = false;
+	UINT64  names = 0;
 	if (node == nullptr || node->value == nullptr) {
 		// Do nothing.
 	} else if (auto list = tp.isa.CommaSeparatedSyntax(node->value)) {
 		for (auto i = 0; i < list->nodes.length; i++) {
 			auto param = list->nodes.items[i];
-			if (tp.isa.NameValueSyntax(param)) {
+			if (auto nv = tp.isa.NameValueSyntax(param)) {
+				names |= TpScope::bloomOf(nv->name->value);
 				if (varags) {
 					template_error(param, "default type parameter after vararg");
 				} else {
@@ -55,22 +57,25 @@ static TpArity mkTemplateParameters(AngledSyntax *node) {
 				}
 			} else if (default_ > 0 || varags) {
 				template_error(param, "required type parameter after either default or vararg");
-			} else if (tp.isa.IdentifierSyntax(param)) {
+			} else if (auto id = tp.isa.IdentifierSyntax(param)) {
+				names |= TpScope::bloomOf(id->value);
 				++required;
 			} else {
 				template_error(param, "expected either identifier, name-value or vararg as a type parameter, not %sk", param->kind);
 			}
 		}
-	} else if (tp.isa.NameValueSyntax(node->value)) {
+	} else if (auto nv = tp.isa.NameValueSyntax(node->value)) {
+		names |= TpScope::bloomOf(nv->name->value);
 		++default_;
 	} else if (tp.isa.RestParameterSyntax(node->value)) {
 		varags = true;
-	} else if (tp.isa.IdentifierSyntax(node->value)) {
+	} else if (auto id = tp.isa.IdentifierSyntax(node->value)) {
+		names |= TpScope::bloomOf(id->value);
 		++required;
 	} else if (node->value != nullptr) {
 		template_error(node->value, "expected either identifier, name-value or vararg");
 	}
-	return { required, default_, varags, /* hasThis = */ false };
+	return { required, default_, varags, /* hasThis = */ false, names };
 }
 
 static IdentifierSyntax* getVariableName(VariableSyntax *syntax) {
@@ -87,6 +92,7 @@ static TpArity mkTemplateParameters(ParenthesizedSyntax *node) {
 	auto default_ = 0;
 	auto   varags = false;
 	auto  hasThis = false;
+	UINT64  names = 0;
 	if (node == nullptr || node->value == nullptr) {
 		// Do nothing.
 	} else if (auto list = tp.isa.CommaSeparatedSyntax(node->value)) {
@@ -95,6 +101,7 @@ static TpArity mkTemplateParameters(ParenthesizedSyntax *node) {
 			auto    param = list->nodes.items[i];
 			if (auto  var = tp.isa.VariableSyntax(param)) {
 				auto name = getVariableName(var);
+				names |= TpScope::bloomOf(name->value);
 				if (varags) {
 					template_error(param, "required or default function parameter after vararg");
 				} else if (var->rhs != nullptr) {
@@ -128,6 +135,7 @@ static TpArity mkTemplateParameters(ParenthesizedSyntax *node) {
 		}
 	} else if (auto var = tp.isa.VariableSyntax(node->value)) {
 		auto name = getVariableName(var);
+		names |= TpScope::bloomOf(name->value);
 		if (var->rhs != nullptr) {
 			++default_;
 			if (name->value == ids.kw_this) {
@@ -150,7 +158,7 @@ static TpArity mkTemplateParameters(ParenthesizedSyntax *node) {
 	} else if (node->value != nullptr) {
 		template_error(node->value, "expected either a function parameter or vararg");
 	}
-	return { required, default_, varags, hasThis };
+	return { required, default_, varags, hasThis, names };
 }
 static auto canCreateOverloadedFrom(TpSymbol *found, Keyword keyword,
 									const TpArity &parameters) {
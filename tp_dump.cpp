@@ -1,9 +1,185 @@
 #include "pch.h"
 #include "tp_dump.h"
+#include "bench.h"
 
 namespace exy {
+void tp_dump::dispose() {
+    sink.dispose();
+    text.dispose();
+}
+
 void tp_dump::run(TpSymbol *moduleSymbol) {
-    auto moduleNode = (TpModule*)moduleSymbol->node;
-    traceln("dumping %tptype @thread(%u#0x#<green>)", &moduleNode->type, GetCurrentThreadId());
+    symbol(text, moduleSymbol, 0);
+}
+
+void tp_dump::symbol(String &out, TpSymbol *symbol, INT depth) {
+    auto node = symbol->node;
+    line(out, depth, "%c %s: %tptype", node->kindName().text, symbol->name, &node->type);
+    if (depth >= 0x100) {
+        return;
+    }
+    switch (node->kind) {
+        case TpKind::OverloadSet: {
+            sorted(out, ((TpOverloadSet*)node)->list, depth + 1);
+        } break;
+        case TpKind::Template: {
+            sorted(out, ((TpTemplate*)node)->instances, depth + 1);
+        } break;
+        case TpKind::Module:
+        case TpKind::Struct:
+        case TpKind::Union:
+        case TpKind::Enum:
+        case TpKind::Function: {
+            if (auto own = ((TpTypeNode*)node)->scope) {
+                scope(out, own, depth + 1);
+            }
+        } break;
+    }
+}
+
+void tp_dump::scope(String &out, TpScope *scope, INT depth) {
+    List<TpSymbol*> owned{};
+    for (auto i = 0; i < scope->symbols.length; i++) {
+        auto sym = scope->symbols.items[i].value;
+        if (sym->scope == scope) {
+            owned.append(sym);
+        } else { // Imported: its own module dumps what is in it.
+            line(out, depth, "import %s: %tptype", sym->name, &sym->node->type);
+        }
+    }
+    sorted(out, owned, depth);
+    owned.dispose();
+    for (auto i = 0; i < scope->statements.length; i++) {
+        auto node = scope->statements.items[i];
+        line(out, depth, "#%c: %tptype", node->kindName().text, &node->type);
+        if (node->kind == TpKind::Block && depth < 0x100) {
+            this->scope(out, ((TpBlock*)node)->scope, depth + 1);
+        }
+    }
+}
+
+// Each of {symbols} as a block of lines, the blocks sorted.
+void tp_dump::sorted(String &out, List<TpSymbol*> &symbols, INT depth) {
+    List<String> blocks{};
+    for (auto i = 0; i < symbols.length; i++) {
+        String block{};
+        symbol(block, symbols.items[i], depth);
+        blocks.append(block);
+    }
+    qsort(blocks.items, size_t(blocks.length), sizeof(String), [](const void *a, const void *b) {
+        return ((const String*)a)->cmp(*(const String*)b);
+    });
+    for (auto i = 0; i < blocks.length; i++) {
+        out.append(blocks.items[i]);
+    }
+    blocks.dispose([](String &block) { block.dispose(); });
+}
+
+// Appends what {fmt} prints to {out} as one indented line, with '`1234`' in random names written as '`#`'.
+void tp_dump::line(String &out, INT depth, const CHAR *fmt, ...) {
+    va_list ap = nullptr;
+    __crt_va_start(ap, fmt);
+    vprint(&stream, fmt, ap);
+    __crt_va_end(ap);
+    for (auto i = 0; i < depth; i++) {
+        out.append(S("  "));
+    }
+    auto &printed = sink.text;
+    auto      run = printed.start();
+    for (auto p = run; p < printed.end(); p++) {
+        if (*p != '`') {
+            continue;
+        }
+        auto q = p + 1;
+        while (q < printed.end() && *q >= '0' && *q <= '9') {
+            q++;
+        }
+        if (q > p + 1 && q < printed.end() && *q == '`') {
+            out.append(run, INT(p - run)).append(S("`#`"));
+            run = q + 1;
+            p = q;
+        }
+    }
+    out.append(run, INT(printed.end() - run)).append(S("\n"));
+    printed.length = 0;
+}
+
+//----------------------------------------------------------
+// Builds the trees again and dumps every module, the text {errors} errors in.
+static void bindAndDump(String &text, INT &errors) {
+    compiler.errors = 0;
+    compiler.disposeTrees(); // Parsed again: the reference bind does not parse lazily.
+    compiler.build();
+    errors = compiler.errors;
+    if (auto tree = compiler.tpTree) {
+        tp_dump dump{};
+        for (auto i = 0; i < tree->modules.length; i++) {
+            dump.run(tree->modules.items[i]);
+        }
+        text = dump.text;
+        dump.text = {};
+        dump.dispose();
+    }
+}
+
+// The line of {text} that starts at {p}, without its '\n'.
+static String lineAt(const String &text, const CHAR *p) {
+    auto end = p;
+    while (end < text.end() && *end != '\n') {
+        end++;
+    }
+    return String{ p, end };
+}
+
+INT checkParallel(INT argc, const CHAR **argv) {
+    ids.initialize();
+    auto result = -1;
+    bench::Options options{};
+    options.shape.resumables = 1;
+    bench::parseOptions(options, argc, argv);
+    auto corpus = false;
+    for (auto i = 0; i < argc; i++) {
+        corpus |= String{ argv[i] } == String{ S("--corpus") };
+    }
+    String folder{};
+    if (compiler.config.initialize() && (!corpus || bench::generate(options.shape, folder))) {
+        String serial{}, parallel{};
+        INT serialErrors{}, parallelErrors{};
+        auto lazy = compiler.config.lazyFunctionBodies;
+        compiler.config.lazyFunctionBodies = false;
+        compiler.config.parallelBinding = false;
+        bindAndDump(serial, serialErrors);
+        compiler.config.lazyFunctionBodies = lazy;
+        compiler.config.parallelBinding = true;
+        bindAndDump(parallel, parallelErrors);
+        auto   s = serial.start(), p = parallel.start();
+        auto row = 1;
+        while (s < serial.end() && p < parallel.end() && *s == *p) {
+            row += *s == '\n';
+            s++, p++;
+        }
+        if (s == serial.end() && p == parallel.end() && serialErrors == parallelErrors) {
+            traceln("serial and parallel binding agree: %i#<green> lines, %i#<green> error%c",
+                    row - 1, serialErrors, serialErrors == 1 ? "" : "s");
+            result = 0;
+        } else {
+            while (s > serial.start() && s[-1] != '\n') {
+                s--, p--;
+            }
+            auto serialLine = lineAt(serial, s), parallelLine = lineAt(parallel, p);
+            traceln("serial and parallel binding differ at line %i#<red>:", row);
+            traceln("  serial:   %s", &serialLine);
+            traceln("  parallel: %s", &parallelLine);
+            traceln("  errors:   %i#<red> serial, %i#<red> parallel", serialErrors, parallelErrors);
+        }
+        serial.dispose();
+        parallel.dispose();
+    }
+    compiler.dispose();
+    if (!options.keep && folder.isNotEmpty()) {
+        bench::removeFolder(folder);
+    }
+    folder.dispose();
+    return result;
 }
 }
\ No newline at end of file
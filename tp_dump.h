@@ -4,9 +4,29 @@
 
 namespace exy {
 struct Typer;
+/*  Writes a module of the typed tree as text that does not depend on the order its binders ran in: the
+*   symbols of each scope sorted by name, each with its kind and type, the instances of each template
+*   sorted the same way, then the kind and type of each of the scope's statements in order. The numbers
+*   of random names are left out, since binders on other threads take them in another order.
+*/
 struct tp_dump {
-    void dispose() {}
+    MemoryFormatSink     sink{};
+    BufferedFormatStream stream{ &sink };
+    String               text{};
+
+    void dispose();
 
     void run(TpSymbol *moduleSymbol);
+private:
+    void symbol(String &out, TpSymbol *symbol, INT depth);
+    void scope(String &out, TpScope *scope, INT depth);
+    void sorted(String &out, List<TpSymbol*> &symbols, INT depth);
+    void line(String &out, INT depth, const CHAR *fmt, ...);
 };
+
+/*  exc --check-parallel [--lazy] [--corpus [shape] [--keep]]: binds the source tree serially without
+*   '--lazy', then with '--parallel' and '--lazy' if it was given, and compares the dumps. With '--corpus'
+*   the tree is a generated one, as '--bench-corpus' takes its shape, with a generator in each file.
+*/
+INT checkParallel(INT argc, const CHAR **argv);
 }
\ No newline at end of file
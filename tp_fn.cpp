@@ -571,6 +571,9 @@ void tp_fn::bindReturn() {
 }
 
 void tp_fn::bindBody() {
+    if (fnSyntax->isLazy) {
+        compiler.syntaxTree->parseLazyBody(fnSyntax);
+    }
     if (fnNode->modifiers.isResumable()) {
         return bindResumableBody();
     }
@@ -608,7 +611,7 @@ void tp_fn::bindResumableBody() {
     fnNode->fnreturn = stNode->type.mkPointer();
     // See resumable.exy in aio for the full definition of the resumable.
     if (stSymbol->bindStatus.begin()) {
-        traceln("%depth binding %tptype", &stNode->type);
+        logln(Typer, Debug, "%depth binding %tptype", &stNode->type);
         tp_current current{ stNode->scope };
         if (tp.enter(current)) { // struct `Resumable` 
             // overlapped: aio.OVERLAPPED
@@ -642,7 +645,7 @@ void tp_fn::bindResumableBody() {
             //---fn `next`(this) {
             if (nextfnSymbol->bindStatus.begin()) {
                 auto nextfnNode = (TpFunction*)nextfnSymbol->node;
-                traceln("%depth binding %tptype", &nextfnNode->type);
+                logln(Typer, Debug, "%depth binding %tptype", &nextfnNode->type);
                 tp_current current2{ nextfnNode->scope };
                 if (tp.enter(current2)) {
                     if (fnSyntax->bodyOp) {
@@ -663,14 +666,14 @@ void tp_fn::bindResumableBody() {
                     tp.leave(current2);
                 }
                 nextfnSymbol->bindStatus.finish();
-                traceln("%depth bound   %tptype (with %i#<red> error%c)", &nextfnNode->type,
-                        compiler.errors - errors, compiler.errors - errors == 1 ? "" : "s");
+                logln(Typer, Debug, "%depth bound   %tptype (with %i#<red> error%c)", &nextfnNode->type,
+                                    compiler.errors - errors, compiler.errors - errors == 1 ? "" : "s");
             } // } fn `next`(this: `Resumable`*) -> T
             tp.leave(current); // } struct `Resumable`
         } // Back to fnScope.
         stSymbol->bindStatus.finish();
-        traceln("%depth bound   %tptype (with %i#<red> error%c)", &stNode->type,
-                compiler.errors - errors, compiler.errors - errors == 1 ? "" : "s");
+        logln(Typer, Debug, "%depth bound   %tptype (with %i#<red> error%c)", &stNode->type,
+                            compiler.errors - errors, compiler.errors - errors == 1 ? "" : "s");
     }
 }
 } // namespace exy
\ No newline at end of file
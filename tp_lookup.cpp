@@ -160,7 +160,7 @@ TpNode* tp_lookup::find(Pos pos, Identifier name) {
     TpSymbol *found = nullptr;
     auto          p = tp.current->scope;
     while (p != nullptr) {
-        if (found = p->contains(name)) {
+        if (found = p->contains(name)) { // Skips the probe of each scope whose bloom bits rule {name} out.
             break;
         }
         p = p->parent;
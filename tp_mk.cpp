@@ -209,7 +209,7 @@ TpSymbol* tp_mk::Template(TpSymbol *ovSymbol, StructureSyntax *syntax, const TpA
     auto symbol = mem.New<TpSymbol>(ovSymbol->scope, name, node);
     node->type = symbol;
     node->parentOv = ov;
-    ov->list.append(symbol);
+    ov->append(symbol);
     tp.applyModifiers(syntax->modifiers, symbol);
     return symbol;
 }
@@ -221,7 +221,7 @@ TpSymbol* tp_mk::Template(TpSymbol *ovSymbol, FunctionSyntax *syntax, const TpAr
     auto symbol = mem.New<TpSymbol>(ovSymbol->scope, name, node);
     node->type = symbol;
     node->parentOv = ov;
-    ov->list.append(symbol);
+    ov->append(symbol);
     tp.applyModifiers(syntax->modifiers, symbol);
     setAsyncOrGenerator(symbol, syntax);
     return symbol;
@@ -311,34 +311,74 @@ static auto exchangeTemplateSymbolWithInstanceSymbol(TpSymbol *templateSymbol, T
     return tp_template_instance_pair{ instanceSymbol, templateSymbol };
 }
 
-tp_template_instance_pair tp_mk::Struct(TpSymbol *templateSymbol) {
-    auto    parentScope = templateSymbol->scope;
-    auto   templateNode = (TpTemplate*)templateSymbol->node;
-    auto   instanceNode = mem.New<TpStruct>(templateNode->pos, templateNode->dotName, TpStruct::OrdinaryStruct);
-    auto instanceSymbol = mem.New<TpSymbol>(parentScope, templateSymbol->name, instanceNode);
-    instanceNode->modifiers = templateNode->modifiers;
-    return exchangeTemplateSymbolWithInstanceSymbol(templateSymbol, instanceSymbol);
+/*  Adds {instanceSymbol} to the instances of the template {templateSymbol} holds. Unlike a lambda's, the
+*   template stays in its symbol: binders on other threads may have looked it up and not used it yet.
+*/
+static auto addInstance(TpSymbol *templateSymbol, TpSymbol *instanceSymbol) {
+    auto templateNode = (TpTemplate*)templateSymbol->node;
+    auto instanceNode = (TpTypeNode*)instanceSymbol->node;
+    templateNode->instances.append(instanceSymbol);
+    instanceNode->type = instanceSymbol;
+    instanceNode->scope = compiler.tpTree->mem.New<TpScope>(templateSymbol->scope, instanceSymbol);
+    return tp_template_instance_pair{ templateSymbol, instanceSymbol };
+}
+
+/*  Makes an instance with {make} under the tree's lock, unless another binder already instantiated the
+*   template with the same {signature}: that instance is returned instead and the caller's
+*   {bindStatus.begin} waits for its binder. Without a {signature}, the template takes no arguments and
+*   has a single instance.
+*/
+template<typename Make>
+static auto instantiate(TpSymbol *symbol, const tp_template_signature &signature, Make make) {
+    auto          &tree = *compiler.tpTree;
+    auto   templateNode = signature.templateNode ? signature.templateNode : (TpTemplate*)symbol->node;
+    auto templateSymbol = templateNode->type.isDirect();
+    tp_template_instance_pair pair{};
+    AcquireSRWLockExclusive(&tree.srw);
+    if (signature.templateNode != nullptr) {
+        auto idx = templateNode->selected.indexOf(signature.hash);
+        if (idx >= 0) {
+            pair = { templateSymbol, templateNode->selected.items[idx].value };
+        } else {
+            pair = addInstance(templateSymbol, make(templateSymbol, templateNode));
+            templateNode->selected.append(signature.hash, pair.instanceSymbol);
+            stats::count(stats::Counter::TemplateInstances);
+        }
+    } else if (templateNode->instances.isNotEmpty()) {
+        pair = { templateSymbol, templateNode->instances.first() };
+    } else {
+        pair = addInstance(templateSymbol, make(templateSymbol, templateNode));
+        stats::count(stats::Counter::TemplateInstances);
+    }
+    ReleaseSRWLockExclusive(&tree.srw);
+    return pair;
+}
+
+tp_template_instance_pair tp_mk::Struct(TpSymbol *symbol, const tp_template_signature &signature) {
+    return instantiate(symbol, signature, [&](TpSymbol *templateSymbol, TpTemplate *templateNode) {
+        auto instanceNode = mem.New<TpStruct>(templateNode->pos, templateNode->dotName, TpStruct::OrdinaryStruct);
+        instanceNode->modifiers = templateNode->modifiers;
+        return mem.New<TpSymbol>(templateSymbol->scope, templateSymbol->name, instanceNode);
+    });
 }
 
-tp_template_instance_pair tp_mk::Function(TpSymbol *templateSymbol) {
-    auto    parentScope = templateSymbol->scope;
-    auto   templateNode = (TpTemplate*)templateSymbol->node;
-    auto     syntaxNode = (FunctionSyntax*)templateNode->syntax;
-    auto   instanceNode = mem.New<TpFunction>(templateNode->pos, syntaxNode->pos.keyword, templateNode->dotName);
-    auto instanceSymbol = mem.New<TpSymbol>(parentScope, templateSymbol->name, instanceNode);
-    instanceNode->modifiers = templateNode->modifiers;
-    return exchangeTemplateSymbolWithInstanceSymbol(templateSymbol, instanceSymbol);
+tp_template_instance_pair tp_mk::Function(TpSymbol *symbol, const tp_template_signature &signature) {
+    return instantiate(symbol, signature, [&](TpSymbol *templateSymbol, TpTemplate *templateNode) {
+        auto   syntaxNode = (FunctionSyntax*)templateNode->syntax;
+        auto instanceNode = mem.New<TpFunction>(templateNode->pos, syntaxNode->pos.keyword, templateNode->dotName);
+        instanceNode->modifiers = templateNode->modifiers;
+        return mem.New<TpSymbol>(templateSymbol->scope, templateSymbol->name, instanceNode);
+    });
 }
 
-tp_template_instance_pair tp_mk::Extern(TpSymbol *templateSymbol, Identifier dllPath) {
-    auto    parentScope = templateSymbol->scope;
-    auto   templateNode = (TpTemplate*)templateSymbol->node;
-    auto     syntaxNode = (FunctionSyntax*)templateNode->syntax;
-    auto   instanceNode = mem.New<TpFunction>(templateNode->pos, syntaxNode->pos.keyword, templateNode->dotName);
-    auto instanceSymbol = mem.New<TpSymbol>(parentScope, templateSymbol->name, instanceNode);
-    instanceNode->modifiers = templateNode->modifiers;
-    instanceNode->dllPath = dllPath;
-    return exchangeTemplateSymbolWithInstanceSymbol(templateSymbol, instanceSymbol);
+tp_template_instance_pair tp_mk::Extern(TpSymbol *symbol, Identifier dllPath, const tp_template_signature &signature) {
+    return instantiate(symbol, signature, [&](TpSymbol *templateSymbol, TpTemplate *templateNode) {
+        auto   syntaxNode = (FunctionSyntax*)templateNode->syntax;
+        auto instanceNode = mem.New<TpFunction>(templateNode->pos, syntaxNode->pos.keyword, templateNode->dotName);
+        instanceNode->modifiers = templateNode->modifiers;
+        instanceNode->dllPath = dllPath;
+        return mem.New<TpSymbol>(templateSymbol->scope, templateSymbol->name, instanceNode);
+    });
 }
 
 TpSymbol* tp_mk::OrdinaryFn(Pos pos, Identifier name) {
@@ -396,12 +436,18 @@ TpSymbol* tp_mk::ResumableStruct(Pos pos) {
     return instanceSymbol;
 }
 
-tp_template_instance_pair tp_mk::LambdaStruct(TpSymbol *templateSymbol) {
-    auto    parentScope = templateSymbol->scope;
-    auto   templateNode = (TpTemplate*)templateSymbol->node;
+/*  A lambda is bound once, by the binder of the function that holds it, and its symbol becomes the
+*   instance: names bound against it so far then name the struct.
+*/
+tp_template_instance_pair tp_mk::LambdaStruct(TpSymbol *symbol) {
+    if (symbol->node->kind != TpKind::Template) {
+        return { symbol->node->type.isDirect(), symbol }; // Already instantiated.
+    }
+    auto   templateNode = (TpTemplate*)symbol->node;
     auto   instanceNode = mem.New<TpStruct>(templateNode->pos, templateNode->dotName, TpStruct::LambdaStruct);
-    auto instanceSymbol = mem.New<TpSymbol>(parentScope, templateSymbol->name, instanceNode);
-    return exchangeTemplateSymbolWithInstanceSymbol(templateSymbol, instanceSymbol);
+    auto instanceSymbol = mem.New<TpSymbol>(symbol->scope, symbol->name, instanceNode);
+    stats::count(stats::Counter::TemplateInstances);
+    return exchangeTemplateSymbolWithInstanceSymbol(symbol, instanceSymbol);
 }
 
 TpSymbol* tp_mk::LambdaFunction(Pos pos) {
@@ -427,7 +473,7 @@ TpSymbol* tp_mk::Symbol(Identifier name, TpSymbolNode *node) {
 
 TpSymbol* tp_mk::Symbol(TpScope *scope, Identifier name, TpSymbolNode *node) {
     auto symbol = mem.New<TpSymbol>(scope, name, node);
-    scope->symbols.append(name, symbol);
+    scope->append(symbol);
     return symbol;
 }
 
@@ -13,6 +13,12 @@ struct tp_template_instance_pair {
     auto& modifiers() { return ((TpSymbolNode*)instanceSymbol->node)->modifiers; }
 };
 
+/*  The arguments a template is instantiated with, hashed by {tp_site::selectInstance}. */
+struct tp_template_signature {
+    TpTemplate *templateNode;
+    UINT64      hash;
+};
+
 struct tp_mk {
     using  Pos = SyntaxNode*;
     using Type = const TpType&;
@@ -57,9 +63,9 @@ struct tp_mk {
     TpSymbol* UrlHandlerTemplate(TpScope *moduleScope, FunctionSyntax*, const TpArity &arity, Identifier name);
     TpSymbol* ExternTemplate(FunctionSyntax*, const TpArity &arity, Identifier name, Identifier dllPath);
 
-    tp_template_instance_pair Struct(TpSymbol *templateSymbol);
-    tp_template_instance_pair Function(TpSymbol *templateSymbol);
-    tp_template_instance_pair Extern(TpSymbol *templateSymbol, Identifier dllPath);
+    tp_template_instance_pair Struct(TpSymbol *templateSymbol, const tp_template_signature &signature);
+    tp_template_instance_pair Function(TpSymbol *templateSymbol, const tp_template_signature &signature);
+    tp_template_instance_pair Extern(TpSymbol *templateSymbol, Identifier dllPath, const tp_template_signature &signature);
     // Compiler generated symbols.
     TpSymbol* OrdinaryFn(Pos, Identifier name);
     TpSymbol* NextFn(Pos);    // fn `next`(this: T*);
@@ -8,10 +8,11 @@ tp_module::tp_module(TpSymbol *moduleSymbol)
 void tp_module::dispose() {}
 
 void tp_module::bind() {
+	stats::Event event{ "Module", "bind module", moduleSymbol->name };
 	const auto errors = compiler.errors;
 	if (moduleSymbol->bindStatus.begin()) {
 		auto node = (TpModule*)moduleSymbol->node;
-		traceln("%depth binding %tptype", &node->type);
+		logln(Module, Debug, "%depth binding %tptype", &node->type);
 		tp_current scope{ node->scope };
 		if (tp.enter(scope)) {
 			auto syntax = node->syntax;
@@ -41,7 +42,7 @@ void tp_module::bind() {
 			tp.leave(scope);
 		}
 		moduleSymbol->bindStatus.finish();
-		traceln("%depth bound   %tptype (with %i#<red> error%c)", &node->type,
+		logln(Module, Debug, "%depth bound   %tptype (with %i#<red> error%c)", &node->type,
 				compiler.errors - errors, compiler.errors - errors == 1 ? "" : "s");
 	}
 }
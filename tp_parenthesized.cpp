@@ -88,10 +88,11 @@ TpNode* tp_parenthesized::call(TpNode *receiver, TpNode *name, TpSymbol *callee)
     return result;
 }
 
-tp_parenthesized::Match tp_parenthesized::matchFunctionTemplateByArity(TpNode *receiver, TpArity &arity) {
+tp_parenthesized::Match tp_parenthesized::matchFunctionInstanceByArity(TpNode *receiver, 
+                                                                       TpFunction *fnNode) {
     auto   arguments = 0;
     auto putReceiver = false;
-    if (arity.hasThis && receiver != nullptr) {
+    if (tp.isa.MemberFunction(fnNode) && receiver != nullptr) {
         ++arguments;
         putReceiver = true;
     }
@@ -103,61 +104,51 @@ tp_parenthesized::Match tp_parenthesized::matchFunctionTemplateByArity(TpNode *r
     if (withSyntax != nullptr) {
         ++arguments;
     }
-    if (arguments < arity.required) {
-        return { /* putReceiver = */ false, /* isOk = */ false};
-    }
-    if (arguments == arity.required) {
-        return { putReceiver, /* isOk = */ true};
-    }
-    if (arity.varags) {
-        return { putReceiver, /* isOk = */ true };
-    }
-    if (arguments <= arity.required + arity.defaults) {
+    if (arguments == fnNode->parameters.length) {
         return { putReceiver, /* isOk = */ true };
     }
     return { /* putReceiver = */ false, /* isOk = */ false };
 }
 
-tp_parenthesized::Match tp_parenthesized::matchFunctionInstanceByArity(TpNode *receiver, 
-                                                                       TpFunction *fnNode) {
-    auto   arguments = 0;
-    auto putReceiver = false;
-    if (tp.isa.MemberFunction(fnNode) && receiver != nullptr) {
+// Counts the arguments (not the receiver) and collects the bloom bits of the named ones.
+void tp_parenthesized::countArguments(INT &arguments, UINT64 &names) {
+    arguments = 0;
+    names = 0;
+    auto count = [&](SyntaxNode *argument) {
         ++arguments;
-        putReceiver = true;
-    }
+        if (auto nv = tp.isa.NameValueSyntax(argument)) {
+            names |= TpScope::bloomOf(nv->name->value);
+        }
+    };
     if (auto list = tp.isa.CommaSeparatedSyntax(argumentsSyntax->value)) {
-        arguments += list->nodes.length;
+        for (auto i = 0; i < list->nodes.length; i++) {
+            count(list->nodes.items[i]);
+        }
     } else if (argumentsSyntax->value != nullptr) {
-        ++arguments;
+        count(argumentsSyntax->value);
     }
     if (withSyntax != nullptr) {
         ++arguments;
     }
-    if (arguments == fnNode->parameters.length) {
-        return { putReceiver, /* isOk = */ true };
-    }
-    return { /* putReceiver = */ false, /* isOk = */ false };
 }
 
 TpNode* tp_parenthesized::callOverloadSet(TpNode *receiver, TpNode *name, TpSymbol *callee) {
     auto ovNode = (TpOverloadSet*)callee->node;
-    for (auto i = 0; i < ovNode->list.length; i++) {
-        auto templateSymbol = ovNode->list.items[i];
+    INT    arguments{};
+    UINT64     names{};
+    countArguments(arguments, names);
+    auto idx = ovNode->indexOf(arguments, receiver != nullptr, names);
+    if (idx >= 0) {
+        auto templateSymbol = ovNode->list.items[idx];
         auto   templateNode = (TpTemplate*)templateSymbol->node;
-        auto templateSyntax = templateNode->syntax;
-        if (tp.isa.FunctionSyntax(templateSyntax)) {
-            auto match = matchFunctionTemplateByArity(receiver, templateNode->arity);
-            if (match.isOk) {
-                if (!match.putReceiver) {
-                    receiver = tp.throwAway(receiver);
-                }
-                return callTemplate(receiver, name, templateSymbol);
+        if (tp.isa.FunctionSyntax(templateNode->syntax)) {
+            if (!templateNode->arity.hasThis) {
+                receiver = tp.throwAway(receiver);
             }
-        } else {
-            call_error(pos, "call syntax cannot choose from templates of %tptype", &ovNode->type);
-            return nullptr;
+            return callTemplate(receiver, name, templateSymbol);
         }
+        call_error(pos, "call syntax cannot choose from templates of %tptype", &ovNode->type);
+        return nullptr;
     }
     call_error(pos, "no template of %tptype matches the arguments supplied", &ovNode->type);
     return nullptr;
@@ -23,9 +23,9 @@ private:
         bool putReceiver;
         bool isOk;
     };
-    Match matchFunctionTemplateByArity(TpNode *receiver, TpArity &arity);
     Match matchFunctionInstanceByArity(TpNode *receiver, TpFunction *fnNode);
 
+    void countArguments(INT &arguments, UINT64 &names);
     TpNode* callOverloadSet(TpNode *receiver, TpNode *name, TpSymbol *callee);
     TpNode* callTemplate(TpNode *receiver, TpNode *name, TpSymbol *callee);
     TpNode* callFunction(TpNode *receiver, TpNode *name, TpSymbol *callee);
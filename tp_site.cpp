@@ -11,8 +11,9 @@ void tp_argument::dispose() {
 }
 
 //----------------------------------------------------------
+// Keeps the buffer of {list} for the next site: see {tp_site_pool}.
 void tp_argument_list::dispose() {
-    list.dispose([](auto &x) { x.dispose(); });
+    list.clear([](auto &x) { x.dispose(); });
 }
 
 bool tp_argument_list::set(TpNode *receiver, EnclosedSyntax *arguments, FunctionSyntax *with) {
@@ -115,8 +116,9 @@ bool tp_parameter::isaRestParameter() const {
 }
 
 //----------------------------------------------------------
+// Keeps the buffer of {list} for the next site: see {tp_site_pool}.
 void tp_parameter_list::dispose() {
-    list.dispose([](auto &x) { x.dispose(); });
+    list.clear([](auto &x) { x.dispose(); });
 }
 
 bool tp_parameter_list::set(TpScope *scope, ParenthesizedSyntax *parameters) {
@@ -360,18 +362,17 @@ bool tp_parameter_list::set(tp_argument_list &arguments) {
         return false;
     }
     if (arguments.list.isNotEmpty()) {
-        // (6) Reorder arguments to align with parameters.
-        List<tp_argument> newList{};
-        newList.reserve(parameters.list.length);
-        newList.length = parameters.list.length;
+        // (6) Reorder arguments to align with parameters, in place: each swap puts one argument where it
+        //     belongs, so the pooled buffer is kept.
         for (argumentIndex = 0; argumentIndex < arguments.list.length; ++argumentIndex) {
             auto &argument = arguments.list.items[argumentIndex];
             Assert(argument.parameterIndex >= 0 && argument.name != nullptr && argument.value != nullptr);
-            Assert(newList.items[argument.parameterIndex].syntax == nullptr);
-            newList.items[argument.parameterIndex] = argument;
+            while (argument.parameterIndex != argumentIndex) {
+                auto &other = arguments.list.items[argument.parameterIndex];
+                Assert(other.parameterIndex != argument.parameterIndex);
+                swap(argument, other);
+            }
         }
-        arguments.list.dispose();
-        arguments.list = newList;
         // (6) Check argument types against typed parameters.
         for (auto i = 0; i < arguments.list.length; ++i) {
             auto  &argument = arguments.list.items[i];
@@ -432,15 +433,44 @@ INT tp_parameter_list::indexOf(Identifier name) {
     return -1;
 }
 
+//----------------------------------------------------------
+void tp_site_pool::dispose() {
+    arguments.dispose([](auto &x) { x.dispose(); });
+    parameters.dispose([](auto &x) { x.dispose(); });
+}
+
+void tp_site_pool::take(tp_site &site) {
+    if (arguments.isNotEmpty()) {
+        site.arguments.list = arguments.pop();
+    }
+    if (parameters.isNotEmpty()) {
+        site.parameters.list = parameters.pop();
+    }
+}
+
+void tp_site_pool::give(tp_site &site) {
+    Assert(site.arguments.list.isEmpty() && site.parameters.list.isEmpty());
+    if (site.arguments.list.capacity > 0) {
+        arguments.append(site.arguments.list);
+    }
+    if (site.parameters.list.capacity > 0) {
+        parameters.append(site.parameters.list);
+    }
+    site.arguments.list = {};
+    site.parameters.list = {};
+}
+
 //----------------------------------------------------------
 tp_site::tp_site(SyntaxNode *syntax)
     : tp(*typer), prev(typer->current->site), pos(syntax) {
     tp.current->site = this;
+    tp.sites.take(*this);
 }
 
 void tp_site::dispose() {
     arguments.dispose();
     parameters.dispose();
+    tp.sites.give(*this);
     tp.current->site = prev;
 }
 
@@ -671,7 +701,7 @@ TpSymbol* tp_site::createAsyncMain(FunctionSyntax *syntax, TpSymbol *asyncSymbol
     auto instanceSymbol = tp.mk.OrdinaryFn(syntax, name);
     auto   instanceNode = (TpFunction*)instanceSymbol->node;
     if (instanceSymbol->bindStatus.begin()) {
-        traceln("%depth binding %tptype", &instanceNode->type);
+        logln(Typer, Debug, "%depth binding %tptype", &instanceNode->type);
         tp_current current{ instanceNode->scope };
         if (tp.enter(current)) {
             instanceNode->modifiers.isStatic = true;
@@ -680,16 +710,54 @@ TpSymbol* tp_site::createAsyncMain(FunctionSyntax *syntax, TpSymbol *asyncSymbol
             tp.leave(current);
         }
         instanceSymbol->bindStatus.finish();
-        traceln("%depth bound   %tptype", &instanceNode->type);
+        logln(Typer, Debug, "%depth bound   %tptype", &instanceNode->type);
     }
     return instanceSymbol;
 }
+
+// Hashes the name, type and nullness of each argument: all that {select##Kind##Instance} looks at.
+UINT64 tp_site::signatureOf() {
+    auto hash = 0xCBF29CE484222325ull;
+    auto  mix = [&hash](UINT64 value) { hash = (hash ^ value) * 0x100000001B3ull; };
+    for (auto i = 0; i < arguments.list.length; i++) {
+        auto &argument = arguments.list.items[i];
+        mix(UINT64(argument.name));
+        mix(argument.value->type.identity());
+        mix(tp.isa.Null(argument.value) != nullptr);
+    }
+    if (hash == 0 || hash == Dict<TpSymbol*, UINT64>::nullHash) {
+        hash = 1;
+    }
+    return hash;
+}
+
+/*  One hash lookup when these argument types selected or instantiated an instance before. Otherwise
+*   falls back to matching every instance and remembers what matched, or leaves the signature for
+*   {bindTemplate} so that binders racing to instantiate the same signature share one instance.
+*/
 TpSymbol* tp_site::selectInstance(TpSymbol *templateSymbol) {
+    auto &tree = *compiler.tpTree;
     auto templateNode = (TpTemplate*)templateSymbol->node;
     auto   syntaxNode = templateNode->syntax;
-    if (templateNode->instances.isNotEmpty()) {
-        for (auto i = 0; i < templateNode->instances.length; i++) {
-            auto instanceSymbol = templateNode->instances.items[i];
+    auto         hash = signatureOf();
+    TpSymbol  *cached = nullptr;
+    List<TpSymbol*> instances{};
+    signature = {};
+    AcquireSRWLockShared(&tree.srw);
+    auto idx = templateNode->selected.indexOf(hash);
+    if (idx >= 0) {
+        cached = templateNode->selected.items[idx].value;
+    } else {
+        instances.append(templateNode->instances); // Other binders may append while these are matched.
+    }
+    ReleaseSRWLockShared(&tree.srw);
+    if (cached != nullptr) {
+        return cached;
+    }
+    TpSymbol *found = nullptr;
+    if (instances.isNotEmpty()) {
+        for (auto i = 0; i < instances.length; i++) {
+            auto instanceSymbol = instances.items[i];
             switch (syntaxNode->pos.keyword) {
             #define ZM(zName, zText) case Keyword::zName: instanceSymbol = select##zName##Instance(instanceSymbol); break;
                 DeclareStructureTypeKeywords(ZM)
@@ -699,15 +767,30 @@ TpSymbol* tp_site::selectInstance(TpSymbol *templateSymbol) {
             #undef ZM
             }
             if (instanceSymbol != nullptr) {
-                return instanceSymbol;
+                found = instanceSymbol;
+                break;
             }
         }
     }
-    return nullptr;
+    instances.dispose();
+    if (found != nullptr) {
+        AcquireSRWLockExclusive(&tree.srw);
+        if (!templateNode->selected.contains(hash)) {
+            templateNode->selected.append(hash, found);
+        }
+        ReleaseSRWLockExclusive(&tree.srw);
+    } else {
+        signature = { templateNode, hash };
+    }
+    return found;
 }
 
 TpSymbol* tp_site::bindTemplate(TpSymbol *templateSymbol) {
-    auto templateNode = (TpTemplate*)templateSymbol->node;
+    stats::Event event{ "Typer", "bind template", templateSymbol->name };
+    if (templateSymbol->node->kind == TpKind::Template && templateSymbol->node != signature.templateNode) {
+        signature = {}; // Not the template {selectInstance} last missed.
+    }
+    auto templateNode = signature.templateNode ? signature.templateNode : (TpTemplate*)templateSymbol->node;
     auto   syntaxNode = templateNode->syntax;
     switch (syntaxNode->pos.keyword) {
     #define ZM(zName, zText) case Keyword::zName: return bind##zName##Template(templateSymbol);
@@ -723,16 +806,16 @@ TpSymbol* tp_site::bindTemplate(TpSymbol *templateSymbol) {
 
 TpSymbol* tp_site::bindStructTemplate(TpSymbol *symbol) {
     const auto   errors = compiler.errors;
-    auto           pair = tp.mk.Struct(symbol);
+    auto           pair = tp.mk.Struct(symbol, signature);
+    signature = {};
     auto templateSymbol = pair.templateSymbol;
     auto instanceSymbol = pair.instanceSymbol;
     auto   instanceNode = (TpStruct*)instanceSymbol->node;
     auto   templateNode = (TpTemplate*)templateSymbol->node;
     auto     syntaxNode = (StructureSyntax*)templateNode->syntax;
     Assert(templateSymbol->bindStatus.isIdle());
-    Assert(instanceSymbol->bindStatus.isIdle());
-    if (instanceSymbol->bindStatus.begin()) {
-        traceln("%depth binding %tptype", &instanceNode->type);
+    if (instanceSymbol->bindStatus.begin()) { // Not if another thread instantiated it first.
+        logln(Typer, Debug, "%depth binding %tptype", &instanceNode->type);
         tp_current current{ instanceNode->scope };
         if (tp.enter(current)) {
             tp.current->pushStructModifiers(syntaxNode->modifiers);
@@ -745,8 +828,8 @@ TpSymbol* tp_site::bindStructTemplate(TpSymbol *symbol) {
             tp.leave(current);
         }
         instanceSymbol->bindStatus.finish();
-        traceln("%depth bound   %tptype (with %i#<red> error%c)", &instanceNode->type,
-                compiler.errors - errors, compiler.errors - errors == 1 ? "" : "s");
+        logln(Typer, Debug, "%depth bound   %tptype (with %i#<red> error%c)", &instanceNode->type,
+                            compiler.errors - errors, compiler.errors - errors == 1 ? "" : "s");
     }
     return instanceSymbol;
 }
@@ -768,16 +851,16 @@ TpSymbol* tp_site::selectUnionInstance(TpSymbol *instanceSymbol) {
 
 TpSymbol* tp_site::bindFnTemplate(TpSymbol *symbol) {
     const auto   errors = compiler.errors;
-    auto           pair = tp.mk.Function(symbol);
+    auto           pair = tp.mk.Function(symbol, signature);
+    signature = {};
     auto templateSymbol = pair.templateSymbol;
     auto instanceSymbol = pair.instanceSymbol;
     auto   instanceNode = (TpFunction*)instanceSymbol->node;
     auto   templateNode = (TpTemplate*)templateSymbol->node;
     auto     syntaxNode = (FunctionSyntax*)templateNode->syntax;
     Assert(templateSymbol->bindStatus.isIdle());
-    Assert(instanceSymbol->bindStatus.isIdle());
     if (instanceSymbol->bindStatus.begin()) {
-        traceln("%depth binding %tptype", &instanceNode->type);
+        logln(Typer, Debug, "%depth binding %tptype", &instanceNode->type);
         tp_current current{ instanceNode->scope };
         if (tp.enter(current)) {
             tp.current->pushFnModifiers(syntaxNode->modifiers);
@@ -791,8 +874,8 @@ TpSymbol* tp_site::bindFnTemplate(TpSymbol *symbol) {
             tp.leave(current);
         }
         instanceSymbol->bindStatus.finish();
-        traceln("%depth bound   %tptype (with %i#<red> error%c)", &instanceNode->type,
-                compiler.errors - errors, compiler.errors - errors == 1 ? "" : "s");
+        logln(Typer, Debug, "%depth bound   %tptype (with %i#<red> error%c)", &instanceNode->type,
+                            compiler.errors - errors, compiler.errors - errors == 1 ? "" : "s");
     }
     return instanceSymbol;
 }
@@ -836,13 +919,13 @@ TpSymbol* tp_site::bindLambdaTemplate(TpSymbol *templateSymbol) {
     auto stSymbol = stPair.instanceSymbol;
     auto   stNode = (TpStruct*)stSymbol->node;
     if (stSymbol->bindStatus.begin()) {
-        traceln("%depth binding %tptype", &stNode->type);
+        logln(Typer, Debug, "%depth binding %tptype", &stNode->type);
         tp_current current{ stNode->scope };
         if (tp.enter(current)) {
             auto fnSymbol = tp.mk.LambdaFunction(syntaxNode);
             auto fnNode = (TpFunction*)fnSymbol->node;
             if (fnSymbol->bindStatus.begin()) {
-                traceln("%depth binding %tptype", &fnNode->type);
+                logln(Typer, Debug, "%depth binding %tptype", &fnNode->type);
                 tp_current current2{ fnNode->scope };
                 if (tp.enter(current2)) { // fn ()(this) { ... }
                     tp.current->pushFnModifiers(syntaxNode->modifiers);
@@ -858,14 +941,14 @@ TpSymbol* tp_site::bindLambdaTemplate(TpSymbol *templateSymbol) {
                     tp.leave(current2);
                 }
                 fnSymbol->bindStatus.finish();
-                traceln("%depth bound   %tptype (with %i#<red> error%c)", &fnNode->type,
-                        compiler.errors - errors, compiler.errors - errors == 1 ? "" : "s");
+                logln(Typer, Debug, "%depth bound   %tptype (with %i#<red> error%c)", &fnNode->type,
+                                    compiler.errors - errors, compiler.errors - errors == 1 ? "" : "s");
             }
             tp.leave(current);
         }
         stSymbol->bindStatus.finish();
-        traceln("%depth bound   %tptype (with %i#<red> error%c)", &stNode->type,
-                compiler.errors - errors, compiler.errors - errors == 1 ? "" : "s");
+        logln(Typer, Debug, "%depth bound   %tptype (with %i#<red> error%c)", &stNode->type,
+                            compiler.errors - errors, compiler.errors - errors == 1 ? "" : "s");
     }
     return stSymbol;
 }
@@ -877,17 +960,17 @@ TpSymbol* tp_site::selectLambdaInstance(TpSymbol *instanceSymbol) {
 
 TpSymbol* tp_site::bindExternTemplate(TpSymbol *symbol) {
     const auto   errors = compiler.errors;
-    auto        dllPath = ((TpTemplate*)symbol->node)->dllPath;
-    auto           pair = tp.mk.Extern(symbol, dllPath);
+    auto        dllPath = (signature.templateNode ? signature.templateNode : (TpTemplate*)symbol->node)->dllPath;
+    auto           pair = tp.mk.Extern(symbol, dllPath, signature);
+    signature = {};
     auto templateSymbol = pair.templateSymbol;
     auto instanceSymbol = pair.instanceSymbol;
     auto   instanceNode = (TpFunction*)instanceSymbol->node;
     auto   templateNode = (TpTemplate*)templateSymbol->node;
     auto     syntaxNode = (FunctionSyntax*)templateNode->syntax;
     Assert(templateSymbol->bindStatus.isIdle());
-    Assert(instanceSymbol->bindStatus.isIdle());
     if (instanceSymbol->bindStatus.begin()) {
-        traceln("%depth binding %tptype", &instanceNode->type);
+        logln(Typer, Debug, "%depth binding %tptype", &instanceNode->type);
         tp_current current{ instanceNode->scope };
         if (tp.enter(current)) {
             tp.current->pushFnModifiers(syntaxNode->modifiers);
@@ -901,8 +984,8 @@ TpSymbol* tp_site::bindExternTemplate(TpSymbol *symbol) {
             tp.leave(current);
         }
         instanceSymbol->bindStatus.finish();
-        traceln("%depth bound   %tptype (with %i#<red> error%c)", &instanceNode->type,
-                compiler.errors - errors, compiler.errors - errors == 1 ? "" : "s");
+        logln(Typer, Debug, "%depth bound   %tptype (with %i#<red> error%c)", &instanceNode->type,
+                            compiler.errors - errors, compiler.errors - errors == 1 ? "" : "s");
     }
     return instanceSymbol;
 }
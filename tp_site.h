@@ -55,6 +55,21 @@ struct tp_parameter_list {
     INT indexOf(Identifier name);
 };
 
+//----------------------------------------------------------
+struct tp_site;
+
+/*  Spare buffers for the argument and parameter lists of one {Typer}'s sites: once sites have nested
+*   as deep as they will, matching arguments to parameters no longer allocates.
+*/
+struct tp_site_pool {
+    List<List<tp_argument>>  arguments{};
+    List<List<tp_parameter>> parameters{};
+
+    void dispose();
+    void take(tp_site &site);
+    void give(tp_site &site);
+};
+
 //----------------------------------------------------------
 struct tp_site {
     Typer      &tp;
@@ -86,6 +101,8 @@ public:
     TpSymbol* selectInstance(TpSymbol *templateSymbol);
     TpSymbol* bindTemplate(TpSymbol *templateSymbol);
 private:
+    tp_template_signature signature{}; // Set when {selectInstance} finds no instance, for {bindTemplate}.
+    UINT64 signatureOf();
 #define ZM(zName, zText) \
     TpSymbol* bind##zName##Template(TpSymbol *templateSymbol); \
     TpSymbol* select##zName##Instance(TpSymbol *instanceSymbol);
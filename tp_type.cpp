@@ -2,115 +2,59 @@
 #include "typer.h"
 
 namespace exy {
-TpType::TpType() : symbol(nullptr), kind(Kind::Unknown) {}
+TpType::TpType() : symbol(nullptr), kind(Kind::Unknown), builtin(0) {}
 
 TpType::TpType(TpSymbol *symbol)
-    : symbol(symbol), kind(Kind::Symbol) {
-
+    : symbol(symbol), kind(Kind::Symbol), builtin(0) {
+    if (symbol->node != nullptr && symbol->node->kind == TpKind::Builtin) {
+        builtin = UINT8(TpBuiltinTraits::indexOf(((TpBuiltin*)symbol->node)->keyword) + 1);
+    }
 }
 
-TpType::TpType(TpIndirectType *ptr, Kind kind) : ptr(ptr), kind(kind) {}
+TpType::TpType(TpIndirectType *ptr, Kind kind) : ptr(ptr), kind(kind), builtin(0) {}
 
 TpSymbol* TpType::isaBuiltin() const {
-    if (kind == Kind::Symbol) {
-        auto node = symbol->node;
-        return node->kind == TpKind::Builtin ? symbol : nullptr;
-    }
-    return nullptr;
+    return builtin ? symbol : nullptr;
 }
 
 TpSymbol* TpType::isNumeric() const {
-    if (auto sym = isaBuiltin()) {
-        auto node = (TpBuiltin*)sym->node;
-        return node->keyword >= Keyword::Char && node->keyword <= Keyword::Double ? sym : nullptr;
-    }
-    return nullptr;
+    return isaBuiltinWith(TpBuiltinTraits::Numeric);
 }
 
 TpSymbol* TpType::isIntegral() const {
-    if (auto sym = isaBuiltin()) {
-        auto node = (TpBuiltin*)sym->node;
-        return node->keyword >= Keyword::Char && node->keyword <= Keyword::UInt64 ? sym : nullptr;
-    }
-    return nullptr;
+    return isaBuiltinWith(TpBuiltinTraits::Integral);
 }
 
 TpSymbol* TpType::isSigned() const {
-    if (auto sym = isaBuiltin()) {
-        auto node = (TpBuiltin*)sym->node;
-        return node->keyword >= Keyword::Char && node->keyword <= Keyword::Int64 ? sym : nullptr;
-    }
-    return nullptr;
+    return isaBuiltinWith(TpBuiltinTraits::Signed);
 }
 
 TpSymbol* TpType::isUnsigned() const {
-    if (auto sym = isaBuiltin()) {
-        auto node = (TpBuiltin*)sym->node;
-        return node->keyword >= Keyword::Bool && node->keyword <= Keyword::UInt64 ? sym : nullptr;
-    }
-    return nullptr;
+    return isaBuiltinWith(TpBuiltinTraits::Unsigned);
 }
 
 TpSymbol* TpType::isaFloatingPoint() const {
-    if (auto sym = isaBuiltin()) {
-        auto node = (TpBuiltin*)sym->node;
-        return node->keyword == Keyword::Float || node->keyword == Keyword::Double ? sym : nullptr;
-    }
-    return nullptr;
+    return isaBuiltinWith(TpBuiltinTraits::FloatingPoint);
 }
 
 TpSymbol* TpType::isPacked() const {
-    if (auto sym = isaBuiltin()) {
-        auto node = (TpBuiltin*)sym->node;
-        return node->keyword >= Keyword::Floatx4 && node->keyword <= Keyword::UInt64x8 ? sym : nullptr;
-    }
-    return nullptr;
+    return isaBuiltinWith(TpBuiltinTraits::Packed);
 }
 
 TpSymbol* TpType::isPackedFloatingPoints() const {
-    if (auto sym = isaBuiltin()) {
-        auto node = (TpBuiltin*)sym->node;
-        return (node->keyword == Keyword::Floatx4 || node->keyword == Keyword::Doublex2) ||
-            (node->keyword == Keyword::Floatx8 || node->keyword == Keyword::Doublex4) ||
-            (node->keyword == Keyword::Floatx16 || node->keyword == Keyword::Doublex8)
-            ? sym : nullptr;
-    }
-    return nullptr;
+    return isaBuiltinWith(TpBuiltinTraits::PackedFloatingPoints);
 }
 
 TpSymbol* TpType::isPackedIntegrals() const {
-    if (auto sym = isaBuiltin()) {
-        auto node = (TpBuiltin*)sym->node;
-        return (node->keyword >= Keyword::Int8x16 && node->keyword <= Keyword::UInt64x2) ||
-            (node->keyword >= Keyword::Int8x32 && node->keyword <= Keyword::UInt64x4) ||
-            (node->keyword >= Keyword::Int8x64 && node->keyword <= Keyword::UInt64x8)
-            ? sym : nullptr;
-    }
-    return nullptr;
+    return isaBuiltinWith(TpBuiltinTraits::PackedIntegrals);
 }
 
 TpSymbol* TpType::isFloatingPointOrPackedFloatingPoints() const {
-    if (auto sym = isaBuiltin()) {
-        auto node = (TpBuiltin*)sym->node;
-        return (node->keyword == Keyword::Float || node->keyword == Keyword::Double) ||
-            (node->keyword == Keyword::Floatx4 || node->keyword == Keyword::Doublex2) ||
-            (node->keyword == Keyword::Floatx8 || node->keyword == Keyword::Doublex4) ||
-            (node->keyword == Keyword::Floatx16 || node->keyword == Keyword::Doublex8)
-            ? sym : nullptr;
-    }
-    return nullptr;
+    return isaBuiltinWith(TpBuiltinTraits::FloatingPoint | TpBuiltinTraits::PackedFloatingPoints);
 }
 
 TpSymbol* TpType::isIntegralOrPackedIntegrals() const {
-    if (auto sym = isaBuiltin()) {
-        auto node = (TpBuiltin*)sym->node;
-        return (node->keyword >= Keyword::Char && node->keyword <= Keyword::UInt64) ||
-            (node->keyword >= Keyword::Int8x16 && node->keyword <= Keyword::UInt64x2) ||
-            (node->keyword >= Keyword::Int8x32 && node->keyword <= Keyword::UInt64x4) ||
-            (node->keyword >= Keyword::Int8x64 && node->keyword <= Keyword::UInt64x8)
-            ? sym : nullptr;
-    }
-    return nullptr;
+    return isaBuiltinWith(TpBuiltinTraits::Integral | TpBuiltinTraits::PackedIntegrals);
 }
 
 bool TpType::isNumericOrIndirect() const {
@@ -230,11 +174,11 @@ TpSymbol* TpType::isaFunctionOrFunctionTemplate() const {
 }
 
 TpType TpType::mkPointer() const {
-    return typer->_types.pointerOf(*this);
+    return typer->types.pointerOf(*this);
 }
 
 TpType TpType::mkReference() const {
-    return typer->_types.referenceOf(*this);
+    return typer->types.referenceOf(*this);
 }
 
 TpType TpType::pointee() const {
@@ -263,88 +207,97 @@ TpIndirectType* TpType::isVoidPointer() const {
     return nullptr;
 }
 
-#define ZM(zName, zSize) TpSymbol* TpType::is##zName() const { if (auto s = isaBuiltin()) { auto b = (TpBuiltin*)s->node; return b->keyword == Keyword::zName ? s : nullptr; } return nullptr; }
+#define ZM(zName, zSize) TpSymbol* TpType::is##zName() const { return builtin == TpBuiltinTraits::indexOf(Keyword::zName) + 1 ? symbol : nullptr; }
 DeclareBuiltinTypeKeywords(ZM)
 #undef ZM
 
+//----------------------------------------------------------
+/*  [lane][0]: the 16 B packed type of that lane type, [1]: 32 B, [2]: 64 B. Char and Bool lanes pack
+*   like Int8 and UInt8; any integral lane packs like the packed integrals of its size and sign.
+*/
+struct TpPackedTypes {
+    Keyword of[TpBuiltinTraits::indexOf(Keyword::Double) + 1][3];
+
+    constexpr TpPackedTypes() : of{} {
+        for (auto &widths : of) {
+            for (auto &packed : widths) {
+                packed = Keyword::Void;
+            }
+        }
+        for (const auto &p : builtinTraits) {
+            if ((p.flags & TpBuiltinTraits::Packed) == 0) {
+                continue;
+            }
+            const auto &lane = builtinTraits[TpBuiltinTraits::indexOf(p.lane)];
+            auto width = p.size == 16 ? 0 : p.size == 32 ? 1 : 2;
+            for (const auto &n : builtinTraits) {
+                if ((n.flags & TpBuiltinTraits::Numeric) && n.size == lane.size &&
+                    (n.flags & ~TpBuiltinTraits::Numeric) == (lane.flags & ~TpBuiltinTraits::Numeric)) {
+                    of[TpBuiltinTraits::indexOf(n.keyword)][width] = p.keyword;
+                }
+            }
+        }
+    }
+};
+
+static constexpr TpPackedTypes packedTypes{};
+
+Keyword TpBuiltinTraits::packedOf(Keyword lane, INT lanes) {
+    auto index = indexOf(lane);
+    if (index < 0 || index >= _countof(packedTypes.of)) {
+        return Keyword::Void;
+    }
+    switch (sizeOf(lane) * lanes) {
+        case 16: return packedTypes.of[index][0];
+        case 32: return packedTypes.of[index][1];
+        case 64: return packedTypes.of[index][2];
+    }
+    return Keyword::Void;
+}
+
 //----------------------------------------------------------
 void TpIndirectTypes::initialize() {
     auto &tree = *compiler.tpTree;
-    auto  &mem = tree.mem;
-    const auto length = INT(Keyword::UInt64x8) - INT(Keyword::Void);
-    builtins.reserve(length);
-#define ZM(zName, zSize) builtins.append(mem.New<TpIndirectType>(tree.ty##zName));
+    // Intern the builtins up front: they are pointed to from everywhere.
+#define ZM(zName, zSize) indirectOf(tree.ty##zName);
     DeclareBuiltinTypeKeywords(ZM)
     #undef ZM
-        builtins.length = length;
-    builtins.compact();
     tree.tyVoidPointer = tree.tyVoid.mkPointer();
 }
 
 void TpIndirectTypes::dispose() {
-    builtins.dispose();
-    ptrs.dispose();
+    // The interned types live in {TpTree::mem}.
 }
 
 TpType TpIndirectTypes::pointerOf(const TpType &type) {
-    auto &tree = *compiler.tpTree;
-    auto  &mem = tree.mem;
-    if (auto  symbol = type.isaBuiltin()) {
-        auto builtin = (TpBuiltin*)symbol->node;
-        auto   index = INT(builtin->keyword) - INT(Keyword::Void);
-        return { builtins.items[index], TpType::Kind::Pointer };
+    return { indirectOf(type), TpType::Kind::Pointer };
+}
+
+TpType TpIndirectTypes::referenceOf(const TpType &type) {
+    return { indirectOf(type), TpType::Kind::Reference };
+}
+
+TpIndirectType* TpIndirectTypes::indirectOf(const TpType &pointee) {
+    if (auto symbol = pointee.isDirect()) {
+        return intern(symbol->indirect, symbol->node->type);
     }
-    if (auto symbol = type.isDirect()) {
-        auto   hash = UINT64(symbol);
-        auto    idx = ptrs.indexOf(hash);
-        if (idx >= 0) {
-            return { ptrs.items[idx].value, TpType::Kind::Pointer };
-        }
-        auto ptr = mem.New<TpIndirectType>(symbol->node->type);
-        ptrs.append(hash, ptr);
-        return { ptr, TpType::Kind::Pointer };
+    if (auto ptr = pointee.isaPointer()) {
+        return intern(ptr->ofPointer, pointee);
     }
-    if (auto  ptr = type.isIndirect()) {
-        auto hash = UINT64(ptr);
-        auto  idx = ptrs.indexOf(hash);
-        if (idx >= 0) {
-            return { ptrs.items[idx].value, TpType::Kind::Pointer };
-        }
-        ptr = mem.New<TpIndirectType>(TpType(ptr, TpType::Kind::Pointer));
-        ptrs.append(hash, ptr);
-        return { ptr, TpType::Kind::Pointer };
+    if (auto ptr = pointee.isaReference()) {
+        return intern(ptr->ofReference, pointee);
     }
     UNREACHABLE();
 }
 
-TpType TpIndirectTypes::referenceOf(const TpType &type) {
-    auto &tree = *compiler.tpTree;
-    auto  &mem = tree.mem;
-    if (auto symbol = type.isaBuiltin()) {
-        auto builtin = (TpBuiltin*)symbol->node;
-        auto   index = INT(builtin->keyword) - INT(Keyword::Void);
-        return { builtins.items[index], TpType::Kind::Reference };
-    }
-    if (auto symbol = type.isDirect()) {
-        auto   hash = UINT64(symbol);
-        auto    idx = ptrs.indexOf(hash);
-        if (idx >= 0) {
-            return { ptrs.items[idx].value, TpType::Kind::Reference };
-        }
-        auto ptr = mem.New<TpIndirectType>(symbol->node->type);
-        ptrs.append(hash, ptr);
-        return { ptr, TpType::Kind::Reference };
+TpIndirectType* TpIndirectTypes::intern(TpIndirectType *volatile &slot, const TpType &pointee) {
+    if (auto ptr = slot) {
+        return ptr;
     }
-    if (auto  ptr = type.isIndirect()) {
-        auto hash = UINT64(ptr);
-        auto  idx = ptrs.indexOf(hash);
-        if (idx >= 0) {
-            return { ptrs.items[idx].value, TpType::Kind::Reference };
-        }
-        ptr = mem.New<TpIndirectType>(TpType(ptr, TpType::Kind::Reference));
-        ptrs.append(hash, ptr);
-        return { ptr, TpType::Kind::Reference };
+    auto ptr = compiler.tpTree->mem.New<TpIndirectType>(pointee);
+    if (auto other = (TpIndirectType*)InterlockedCompareExchangePointer((PVOID volatile*)&slot, ptr, nullptr)) {
+        return other; // Another binder published first; {ptr} stays unused in the arena.
     }
-    UNREACHABLE();
+    return ptr;
 }
 } // namespace exy
\ No newline at end of file
@@ -4,6 +4,75 @@ namespace exy {
 struct TpSymbol;
 struct TpIndirectType;
 
+/*  What the typer asks of each builtin type, generated from {DeclareBuiltinTypeKeywords} and indexed
+*   by {indexOf} its keyword. A {TpType} of a builtin caches that index so that asking is one load.
+*/
+struct TpBuiltinTraits {
+    enum Flags : UINT8 {
+        Numeric              = 0x01, // Char ... Double
+        Integral             = 0x02, // Char ... UInt64
+        Signed               = 0x04, // Char ... Int64
+        Unsigned             = 0x08, // Bool ... UInt64
+        FloatingPoint        = 0x10, // Float | Double
+        Packed               = 0x20, // Floatx4 ... UInt64x8
+        PackedFloatingPoints = 0x40, // Floatx4 | Doublex2 | Floatx8 | Doublex4 | Floatx16 | Doublex8
+        PackedIntegrals      = 0x80, // Int8x16 ... UInt64x2 | Int8x32 ... UInt64x4 | Int8x64 ... UInt64x8
+    };
+    Keyword keyword;
+    UINT8   size;
+    UINT8   flags;
+    Keyword lane;  // Packed only: the type of each lane.
+    UINT8   lanes; // Packed only: the number of lanes.
+
+    static constexpr INT indexOf(Keyword keyword) { return INT(keyword) - INT(Keyword::Void); }
+
+    static constexpr UINT8 sizeOf(Keyword keyword) {
+        switch (keyword) {
+        #define ZM(zName, zSize) case Keyword::zName: return zSize;
+            DeclareBuiltinTypeKeywords(ZM)
+        #undef ZM
+        }
+        return 0;
+    }
+
+    static constexpr UINT8 flagsOf(Keyword k) {
+        if (k >= Keyword::Char && k <= Keyword::Int64) return Numeric | Integral | Signed;
+        if (k >= Keyword::Bool && k <= Keyword::UInt64) return Numeric | Integral | Unsigned;
+        if (k == Keyword::Float || k == Keyword::Double) return Numeric | FloatingPoint;
+        if (k >= Keyword::Floatx4 && k <= Keyword::UInt64x8) {
+            return Packed | (flagsOf(laneOf(k)) & FloatingPoint ? PackedFloatingPoints : PackedIntegrals);
+        }
+        return 0;
+    }
+
+    // Each size of packed types declares one type per lane type, in the same order.
+    static constexpr Keyword laneOf(Keyword k) {
+        constexpr Keyword lanes[] = {
+            Keyword::Float, Keyword::Double, Keyword::Int8,  Keyword::Int16,  Keyword::Int32,
+            Keyword::Int64, Keyword::UInt8,  Keyword::UInt16, Keyword::UInt32, Keyword::UInt64
+        };
+        static_assert(INT(Keyword::UInt64x8) - INT(Keyword::Floatx4) + 1 == 3 * _countof(lanes));
+        if (k >= Keyword::Floatx4 && k <= Keyword::UInt64x8) {
+            return lanes[(INT(k) - INT(Keyword::Floatx4)) % _countof(lanes)];
+        }
+        return Keyword::Void;
+    }
+
+    static constexpr UINT8 lanesOf(Keyword k) {
+        auto lane = laneOf(k);
+        return lane == Keyword::Void ? 0 : sizeOf(k) / sizeOf(lane);
+    }
+
+    static Keyword packedOf(Keyword lane, INT lanes); // {Keyword::Void} if there is no such packed type.
+};
+
+inline constexpr TpBuiltinTraits builtinTraits[] = {
+#define ZM(zName, zSize) { Keyword::zName, zSize, TpBuiltinTraits::flagsOf(Keyword::zName), \
+                           TpBuiltinTraits::laneOf(Keyword::zName), TpBuiltinTraits::lanesOf(Keyword::zName) },
+    DeclareBuiltinTypeKeywords(ZM)
+#undef ZM
+};
+
 struct TpType {
     enum class Kind {
         Unknown,
@@ -21,6 +90,8 @@ struct TpType {
     auto isUnknown() const { return kind == Kind::Unknown; }
     auto isKnown()   const { return kind != Kind::Unknown; }
 
+    auto identity() const { return UINT64(ptr) | UINT64(kind); } // Unique per type: {symbol}s and interned {ptr}s are aligned.
+
     auto isDirect()   const { return kind == Kind::Symbol ? symbol : nullptr; }
     auto isIndirect() const { return kind == Kind::Pointer || kind == Kind::Reference ? ptr : nullptr; }
 
@@ -101,21 +172,35 @@ struct TpType {
     DeclareBuiltinTypeKeywords(ZM)
     #undef ZM
 
+    // The traits of {this} builtin type; {nullptr} if {this} is not a builtin.
+    auto builtinTraitsOf() const { return builtin ? &builtinTraits[builtin - 1] : nullptr; }
+
 private:
     union {
         TpSymbol       *symbol;
         TpIndirectType *ptr;
     };
-    Kind kind;
+    Kind  kind;
+    UINT8 builtin; // 1 + {TpBuiltinTraits::indexOf} the keyword of a builtin type; 0 for any other type.
+
+    TpSymbol* isaBuiltinWith(UINT8 flags) const {
+        return builtin && (builtinTraits[builtin - 1].flags & flags) ? symbol : nullptr;
+    }
 };
 
 struct TpIndirectType {
     TpType pointee;
+    TpIndirectType *volatile ofPointer   = nullptr; // The {TpIndirectType} whose {pointee} is {this} as a pointer.
+    TpIndirectType *volatile ofReference = nullptr; // The {TpIndirectType} whose {pointee} is {this} as a reference.
 
     TpIndirectType(const TpType &pointee) : pointee(pointee) {}
 };
 
 //----------------------------------------------------------
+/*  Interns the {TpIndirectType} of each pointee in a slot of the pointee itself ({TpSymbol::indirect},
+*   {TpIndirectType::ofPointer} or {ofReference}): after the first time, {mkPointer} and {mkReference}
+*   are one load. The first binder to publish a slot wins, so no lock is taken.
+*/
 struct TpIndirectTypes {
     void initialize();
     void dispose();
@@ -124,7 +209,7 @@ struct TpIndirectTypes {
     TpType referenceOf(const TpType&);
 
 private:
-    List<TpIndirectType*> builtins{};
-    Dict<TpIndirectType*, UINT64> ptrs{};
+    TpIndirectType* indirectOf(const TpType &pointee);
+    TpIndirectType* intern(TpIndirectType *volatile &slot, const TpType &pointee);
 };
 } // namespace exy
\ No newline at end of file
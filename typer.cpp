@@ -1,18 +1,38 @@
 #include "pch.h"
 #include "typer.h"
 
-#include "tp_dump.h"
-
 namespace exy {
 Typer::Typer() 
-    : tree(*compiler.tpTree), mem(compiler.tpTree->mem), mk(this) {
+    : tree(*compiler.tpTree), mem(compiler.tpTree->mem), mk(this), types(_types), casts(_casts) {
 	typer = this;
 	_types.initialize();
+	_casts.initialize();
+}
+
+Typer::Typer(Typer &parent)
+    : tree(parent.tree), mem(parent.mem), mk(this), types(parent.types), casts(parent.casts) {
+	typer = this;
+	mod_aio            = parent.mod_aio;
+	sym_aio_OVERLAPPED = parent.sym_aio_OVERLAPPED;
+	sym_aio_SRWLOCK    = parent.sym_aio_SRWLOCK;
+	sym_aio_startup    = parent.sym_aio_startup;
+	sym_aio_shutdown   = parent.sym_aio_shutdown;
+	mod_std            = parent.mod_std;
+	sym_std_startup    = parent.sym_std_startup;
+	sym_std_shutdown   = parent.sym_std_shutdown;
+	sym_std_string     = parent.sym_std_string;
+	sym_std_String     = parent.sym_std_String;
+	sym_std_wstring    = parent.sym_std_wstring;
+	sym_std_WString    = parent.sym_std_WString;
+	mod_collections    = parent.mod_collections;
 }
 
 void Typer::dispose() {
 	Assert(current == nullptr);
 	ldispose(_thrown);
+	sites.dispose();
+	castCache.dispose();
+	_casts.dispose();
 	_types.dispose();
 	typer = nullptr;
 }
@@ -20,7 +40,7 @@ void Typer::dispose() {
 void Typer::run() {
 	tp_current scope{ tree.scope };
 	if (enter(scope)) {
-		traceln("binding...");
+		logln(Typer, Info, "binding...");
 		auto hasCreatedBuiltinAliases = false;
 		for (auto i = 0; i < tree.modules.length; i++) {
 			auto symbol = tree.modules.items[i];
@@ -38,17 +58,57 @@ void Typer::run() {
 					}
 					//--
 					hasCreatedBuiltinAliases = true;
+					if (compiler.config.parallelBinding) {
+						runParallel();
+						break;
+					}
 				}
 				bindModule(symbol);
 			}
 		}
-		traceln("...finished binding with %i#<red> error%c", 
+		logln(Typer, Info, "...finished binding with %i#<red> error%c", 
 				compiler.errors, compiler.errors == 1 ? "" : "s");
 		leave(scope);
 	}
-	tp_dump dump{ };
-	aio::run(dump, tree.modules);
-	dump.dispose();
+}
+
+/*  Binds each module with a {main} file on the aio threads, each thread with its own {Typer}.
+*   A module or template another thread is busy binding is waited on by {Status::begin}, the
+*   same place where a single thread would have found it busy with itself. Instantiating a template
+*   leaves it where other binders look it up (see {tp_mk::Struct}). 'exc --check-parallel' compares
+*   the result with a serial bind.
+*/
+struct tp_binder {
+	Typer &parent;
+
+	void dispose() {}
+
+	void run(TpSymbol *moduleSymbol) {
+		auto prev = typer; // Set if this is the thread that called {runParallel}.
+		Typer tp{ parent };
+		tp_current scope{ tp.tree.scope };
+		if (tp.enter(scope)) {
+			tp.bindModule(moduleSymbol);
+			tp.leave(scope);
+		}
+		tp.dispose();
+		typer = prev;
+	}
+};
+
+void Typer::runParallel() {
+	List<TpSymbol*> mains{};
+	for (auto i = 0; i < tree.modules.length; i++) {
+		auto symbol = tree.modules.items[i];
+		auto   node = (TpModule*)symbol->node;
+		if (node->syntax->main != nullptr) {
+			mains.append(symbol);
+		}
+	}
+	tp_binder binder{ *this };
+	aio::run(binder, mains);
+	binder.dispose();
+	mains.dispose();
 }
 
 void Typer::makeBuiltinAliases(SyntaxNode *syntax) {
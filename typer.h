@@ -27,7 +27,7 @@ struct tp_parenthesized;
 struct tp_bracketed;
 struct tp_braced;
 struct tp_lambda;
-__declspec(selectany) Typer *typer = nullptr;
+inline thread_local Typer *typer = nullptr; // One {Typer} per binding thread.
 } // namespace exy
 
 #include "tp_mk.h"
@@ -56,6 +56,11 @@ struct Typer {
     tp_mk       mk;
     List<TpNode*>   _thrown;
     TpIndirectTypes _types{};
+    TpIndirectTypes &types; // Shared by all the {Typer}s binding {tree}.
+    tp_site_pool     sites{};
+    tp_cast_matrix  _casts{};
+    tp_cast_matrix  &casts; // Shared by all the {Typer}s binding {tree}.
+    tp_cast_cache    castCache{};
 
     TpSymbol *mod_aio = nullptr;
     TpSymbol *sym_aio_OVERLAPPED = nullptr;
@@ -74,10 +79,12 @@ struct Typer {
     TpSymbol *mod_collections = nullptr;
 
     Typer();
+    Typer(Typer &parent);
     void dispose();
 
     // typer.cpp
     void run();
+    void runParallel();
     void makeBuiltinAliases(SyntaxNode*);
 
     SourcePos mkPos(SyntaxNode*);
@@ -159,6 +166,7 @@ struct Typer {
     TpNode* cast(SyntaxNode *pos, TpNode *src, const TpType &dst, tp_cast_reason);
     TpNode* cast(SyntaxNode *pos, TpNode *src, const TpType &dst, tp_cast_list&);
     tp_cast_list canCast(TpNode *src, const TpType &dst, tp_cast_reason);
+    tp_cast_list canCast(const TpType &src, bool isNull, const TpType &dst, tp_cast_reason);
     tp_cast_list canBitCast(TpNode *src, const TpType &dst, tp_cast_reason);
     TpType upperBound(Type lhs, Type rhs, Tok op = Tok::Unknown);
 